@@ -0,0 +1,84 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 Ndc;
+
+// One texel per hole: 1 hole, 2 marble, 4 selected, 8 hint
+uniform usampler2D board;
+uniform int boardSize;
+
+layout (std140) uniform ThemeBlock {
+    mat4 projection;
+    vec4 backgroundColor;
+    vec4 boardColor;
+    vec4 marbleColor;
+    vec4 selectionColor;
+    vec4 hintColor;
+    vec4 winnableColor;
+    vec4 deadColor;
+    vec4 pendingColor;
+    vec4 placement;       // Board origin x, origin y, width
+    vec4 scales;          // Cell, marble, overlay, marble depth
+};
+
+// Straight-alpha "over", matching the blended draws of the per-cell renderer
+vec4 over(vec4 top, vec4 under) {
+    float alpha = top.a + under.a * (1.0 - top.a);
+    if (alpha <= 0.0) {
+        return vec4(0.0);
+    }
+    return vec4((top.rgb * top.a + under.rgb * under.a * (1.0 - top.a)) / alpha, alpha);
+}
+
+void main() {
+    vec2 origin = placement.xy;
+    float cellScale = scales.x;
+    float marbleScale = scales.y;
+    float cellSize = placement.z / float(boardSize);
+    vec2 grid = vec2(Ndc.x - origin.x, origin.y - Ndc.y) / cellSize;
+    ivec2 cell = ivec2(floor(grid));
+    if (any(lessThan(cell, ivec2(0))) || any(greaterThanEqual(cell, ivec2(boardSize)))) {
+        discard;
+    }
+
+    uint flags = texelFetch(board, cell, 0).r;
+    if ((flags & 1u) == 0u) {
+        discard;
+    }
+
+    // Offset from the centre of the cell, in cells
+    vec2 local = fract(grid) - vec2(0.5);
+    float square = max(abs(local.x), abs(local.y));
+
+    vec4 color = vec4(0.0);
+    if (square <= cellScale * 0.5) {
+        color = boardColor;
+    }
+
+    if ((flags & 2u) != 0u) {
+        // Same lighting as marble.fs, over the marble's own quad
+        float dist = length(local / marbleScale);
+        if (dist <= 0.45) {
+            float brightness = 1.0 - (dist * 1.5);
+            brightness += pow(1.0 - dist, 3.0) * 0.4;
+            brightness = max(brightness, 0.3);
+            // Clamped like any fragment written to the framebuffer before blending
+            color = over(clamp(marbleColor * brightness, 0.0, 1.0), color);
+        }
+    }
+
+    // Selection and hint squares are a little larger than the cell
+    if (square <= (cellScale + 0.05) * 0.5) {
+        if ((flags & 4u) != 0u) {
+            color = over(selectionColor, color);
+        }
+        if ((flags & 8u) != 0u) {
+            color = over(hintColor, color);
+        }
+    }
+
+    if (color.a <= 0.0) {
+        discard;
+    }
+    FragColor = color;
+}
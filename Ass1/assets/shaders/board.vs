@@ -0,0 +1,24 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+
+out vec2 Ndc;
+
+layout (std140) uniform ThemeBlock {
+    mat4 projection;
+    vec4 backgroundColor;
+    vec4 boardColor;
+    vec4 marbleColor;
+    vec4 selectionColor;
+    vec4 hintColor;
+    vec4 winnableColor;
+    vec4 deadColor;
+    vec4 pendingColor;
+    vec4 placement;       // Board origin x, origin y, width
+    vec4 scales;          // Cell, marble, overlay, marble depth
+};
+
+void main() {
+    // The unit quad stretched over the board; nothing outside it needs shading
+    Ndc = placement.xy + vec2(aPos.x + 0.5, aPos.y - 0.5) * placement.z;
+    gl_Position = vec4(Ndc, 0.0, 1.0);
+}
@@ -0,0 +1,28 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aPlacement;  // centre x, centre y, size, depth
+layout (location = 2) in vec4 aColor;
+
+out vec2 TexCoords;
+out vec4 InstanceColor;
+
+layout (std140) uniform ThemeBlock {
+    mat4 projection;
+    vec4 backgroundColor;
+    vec4 boardColor;
+    vec4 marbleColor;
+    vec4 selectionColor;
+    vec4 hintColor;
+    vec4 winnableColor;
+    vec4 deadColor;
+    vec4 pendingColor;
+    vec4 placement;       // Board origin x, origin y, width
+    vec4 scales;          // Cell, marble, overlay, marble depth
+};
+
+void main() {
+    // Every quad of the board is an instance of the unit quad: cells, marbles, rings, highlights
+    gl_Position = projection * vec4(aPlacement.xy + aPos * aPlacement.z, aPlacement.w, 1.0);
+    TexCoords = aPos + vec2(0.5, 0.5);
+    InstanceColor = aColor;
+}
@@ -0,0 +1,20 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec4 InstanceColor;
+
+void main() {
+    // A lit glass marble, its colour per instance
+    float dist = distance(TexCoords, vec2(0.5, 0.5));
+    if (dist > 0.45) {
+        discard;
+    }
+
+    float brightness = 1.0 - (dist * 1.5);
+    float reflection = pow(1.0 - dist, 3.0) * 0.4;
+    brightness += reflection;
+    brightness = max(brightness, 0.3);
+
+    FragColor = InstanceColor * brightness;
+}
@@ -0,0 +1,14 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec4 InstanceColor;
+
+void main() {
+    // A ring around the cell, leaving the marble itself visible
+    float dist = distance(TexCoords, vec2(0.5, 0.5));
+    if (dist > 0.48 || dist < 0.38) {
+        discard;
+    }
+    FragColor = InstanceColor;
+}
@@ -0,0 +1,15 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec4 InstanceColor;
+
+uniform sampler2D sprite;   // r: brightness / 2, g: coverage
+
+void main() {
+    // marble.fs looked up instead of computed: no distance, pow or discard.
+    // Outside the circle the coverage is zero, so blending leaves the board.
+    vec2 texel = texture(sprite, TexCoords).rg;
+    vec4 lit = clamp(InstanceColor * (texel.r * 2.0), 0.0, 1.0);
+    FragColor = vec4(lit.rgb, lit.a * texel.g);
+}
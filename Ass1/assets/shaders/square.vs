@@ -1,9 +0,0 @@
-#version 330 core
-layout (location = 0) in vec2 aPos;
-
-uniform mat4 transform;
-uniform mat4 projection;
-
-void main() {
-    gl_Position = projection * transform * vec4(aPos, 0.0, 1.0);
-}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 Local;
+flat in int Board;
+
+// One texel per board: pegs low, pegs high, jumps played, state (1 won, 2 lost)
+uniform usampler2D boards;
+uniform int textureWidth;
+uniform int boardSize;
+uniform uvec2 holes;          // Bitboard of the holes, low and high words
+
+layout (std140) uniform ThemeBlock {
+    mat4 projection;
+    vec4 backgroundColor;
+    vec4 boardColor;
+    vec4 marbleColor;
+    vec4 selectionColor;
+    vec4 hintColor;
+    vec4 winnableColor;
+    vec4 deadColor;
+    vec4 pendingColor;
+    vec4 placement;       // Board origin x, origin y, width
+    vec4 scales;          // Cell, marble, overlay, marble depth
+};
+
+bool hasBit(uvec2 mask, int bit) {
+    uint word = bit < 32 ? mask.x : mask.y;
+    return ((word >> uint(bit & 31)) & 1u) != 0u;
+}
+
+void main() {
+    // A small margin keeps neighbouring boards apart
+    vec2 inside = (Local - vec2(0.05)) / 0.9;
+    if (any(lessThan(inside, vec2(0.0))) || any(greaterThanEqual(inside, vec2(1.0)))) {
+        discard;
+    }
+
+    vec2 grid = inside * float(boardSize);
+    ivec2 cell = ivec2(floor(grid));
+    int bit = cell.y * boardSize + cell.x;
+    if (!hasBit(holes, bit)) {
+        discard;
+    }
+
+    uvec4 board = texelFetch(boards, ivec2(Board % textureWidth, Board / textureWidth), 0);
+    vec2 local = fract(grid) - vec2(0.5);
+
+    float cellScale = scales.x;
+    float marbleScale = scales.y;
+
+    vec4 color = vec4(0.0);
+    if (max(abs(local.x), abs(local.y)) <= cellScale * 0.5) {
+        // Finished games are tinted until they restart
+        color = board.w == 1u ? mix(boardColor, winnableColor, 0.6)
+              : board.w == 2u ? mix(boardColor, deadColor, 0.6) : boardColor;
+    }
+
+    if (hasBit(board.xy, bit)) {
+        // Same lighting as marble.fs
+        float dist = length(local / marbleScale);
+        if (dist <= 0.45) {
+            float brightness = 1.0 - (dist * 1.5);
+            brightness += pow(1.0 - dist, 3.0) * 0.4;
+            // The marble always sits on its square, so blending is a mix
+            vec4 marble = clamp(marbleColor * max(brightness, 0.3), 0.0, 1.0);
+            color.rgb = mix(color.rgb, marble.rgb, marble.a);
+        }
+    }
+
+    if (color.a <= 0.0) {
+        discard;
+    }
+    FragColor = color;
+}
@@ -0,0 +1,17 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+
+out vec2 Local;           // 0..1 across the tile, y pointing down
+flat out int Board;
+
+uniform int columns;
+uniform vec2 tileSize;    // In normalised device coordinates
+
+void main() {
+    // One instance per board, tiled row by row from the top left
+    Board = gl_InstanceID;
+    vec2 tile = vec2(gl_InstanceID % columns, gl_InstanceID / columns);
+    vec2 corner = vec2(-1.0 + tile.x * tileSize.x, 1.0 - tile.y * tileSize.y);
+    Local = vec2(aPos.x + 0.5, 0.5 - aPos.y);
+    gl_Position = vec4(corner + vec2(Local.x, -Local.y) * tileSize, 0.0, 1.0);
+}
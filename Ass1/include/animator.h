@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+#include "board_layout.h"
+#include "game.h"
+#include "theme.h"
+
+// Simulation rate of the animator, independent of the frame rate
+const double ANIMATION_STEP_SECONDS = 1.0 / 120.0;
+// A long stall (a dragged window, a breakpoint) is not replayed step by step
+const double ANIMATION_MAX_FRAME_SECONDS = 0.25;
+const float JUMP_SECONDS = 0.18f;
+const float CAPTURE_SECONDS = 0.22f;
+
+// One marble in flight: a jump sliding between cells, or a captured marble
+// shrinking away (or growing back on undo). Positions are in cells, so a
+// theme change mid-flight is picked up by the next frame.
+struct Tween {
+    float fromRow, fromCol, toRow, toCol;
+    float fromScale, toScale;       // Relative to a resting marble
+    float fromAlpha, toAlpha;
+    float arc;                      // Extra scale at the middle of a jump, as if lifted off the board
+    float start, duration;          // Simulation seconds
+    int hiddenRow, hiddenCol;       // Cell whose resting marble waits for this tween; -1 for none
+};
+
+// The move animations between a game and its renderer, without a single
+// OpenGL call. Board changes arrive as move events; each becomes a tween in
+// one flat array. A fixed-step accumulator owns simulation time and retires
+// finished tweens in a single pass, while frames sample the tweens at the
+// exact time between steps, so motion is the same at any frame rate. With
+// nothing in flight, advance() and buildInstances() return straight away.
+class Animator {
+public:
+    Animator();
+
+    // Turns the game's pending move events into tweens
+    void consume(MarbleSolitaire& game);
+    void advance(double frameSeconds);
+    bool isActive() const { return !tweens.empty(); }
+    void clear();
+
+    // One instance per marble in flight, as instance.vs expects
+    void buildInstances(const MarbleSolitaire& game, const Theme& theme);
+
+    const std::vector<QuadInstance>& getInstances() const { return instances; }
+    // Cells whose resting marble the board must not draw yet
+    const std::vector<Position>& getHiddenCells() const { return hidden; }
+
+private:
+    void add(const Tween& tween);
+    // Drops tweens that end on a cell the new move touches: the new move wins
+    void interrupt(const Move& move);
+    void step();
+
+    std::vector<Tween> tweens;
+    std::vector<Position> hidden;
+    std::vector<QuadInstance> instances;
+    std::vector<MoveEvent> events;
+    double now;                     // Simulation time
+    double accumulator;             // Frame time not yet simulated, under one step
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.h"
+#include "move_ordering.h"
+#include "search_state.h"
+#include "transposition_table.h"
+
+enum AnytimeStatus {
+    ANYTIME_IDLE,        // Nothing started yet
+    ANYTIME_RUNNING,     // More steps needed
+    ANYTIME_SOLVED,      // The best line ends with a single marble
+    ANYTIME_EXHAUSTED    // Every line was tried; the best line is as good as it gets
+};
+
+// Resumable depth-first solver for running inside a frame loop on the main
+// thread. The search keeps an explicit stack of frames, so step() can stop
+// after any node and the next call carries on exactly where it left off.
+// The best partial line found so far is always available as a hint.
+class AnytimeSolver {
+public:
+    // Without an orderer, jumps are tried in the board's generated order
+    explicit AnytimeSolver(const BoardShape& shape, MoveOrderer* orderer = nullptr, size_t tableMegabytes = 16);
+
+    // Starts a new search, dropping the previous one
+    void start(Bitboard pegs, int goalHole = -1);
+
+    // Searches until either budget runs out (0 means no limit on that budget)
+    AnytimeStatus step(uint64_t maxNodes, int maxMicroseconds = 0);
+
+    AnytimeStatus getStatus() const { return status; }
+    Bitboard getStart() const { return startPegs; }
+    uint64_t getNodes() const { return nodes; }
+
+    // Jump ids of the line leaving the fewest marbles so far
+    const std::vector<int>& getBestLine() const { return bestLine; }
+    int getBestPegs() const { return bestPegs; }
+
+    // First move of the best line; false if no move is known yet
+    bool getHint(Move& move) const;
+
+private:
+    struct Frame {
+        BoardState state;
+        Bitboard key;
+        uint32_t firstJump;    // This frame's jumps on the jump stack
+        uint32_t endJump;
+        uint32_t nextJump;
+        int fewestPegs;        // Fewest marbles left below this frame so far
+    };
+
+    void push(const BoardState& state, Bitboard key);
+    void leaf(const BoardState& state, int fewestPegs);
+
+    const BoardShape& shape;
+    MoveOrderer* orderer;
+    TranspositionTable table;
+    Bitboard startPegs;
+    Bitboard goalMask;
+    int symmetryMask;
+    AnytimeStatus status;
+    uint64_t nodes;
+
+    std::vector<int> bestLine;
+    int bestPegs;
+
+    Arena arena;
+    FlatStack<Frame> frames;
+    FlatStack<int> jumps;
+    FlatStack<int> line;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.h"
+
+struct BidirectionalResult {
+    bool solved = false;
+    std::vector<Move> line;        // Single jumps from the start to the goal
+    int meetPegs = 0;              // Peg count where the two searches met
+    size_t forwardStates = 0;
+    size_t backwardStates = 0;
+    double seconds = 0.0;
+};
+
+// Meet-in-the-middle solver for reaching an arbitrary goal position.
+// Expands forward from the start with jumps and backward from the goal with
+// unjumps, one peg-count layer at a time, always growing the smaller
+// frontier. Each layer is kept as a sorted vector of canonical boards and the
+// search stops once both sides reach the same peg count.
+class BidirectionalSolver {
+public:
+    explicit BidirectionalSolver(const BoardShape& shape);
+
+    // meetPegs < 0 lets the solver pick the meeting layer as it goes
+    BidirectionalResult solve(Bitboard start, Bitboard goal, int meetPegs = -1);
+
+    // Goal helper: a single marble left in the given hole
+    Bitboard singlePegGoal(int hole) const { return Bitboard(1) << hole; }
+
+private:
+    typedef std::vector<Bitboard> Layer;
+
+    void expand(const Layer& from, Layer& to, bool forward) const;
+    bool contains(const Layer& layer, Bitboard pegs) const;
+    std::vector<Bitboard> tracePath(Bitboard meet, int startPegs, int goalPegs, int meetPegs) const;
+
+    const BoardShape& shape;
+    int symmetryMask;
+    std::vector<Layer> forwardLayers;   // Indexed by peg count
+    std::vector<Layer> backwardLayers;
+};
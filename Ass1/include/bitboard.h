@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game.h"
+
+// Packed board: bit (row * size + col) is set when that hole holds a marble.
+// Boards up to 8x8 fit, which covers the English (33) and French (37) layouts.
+typedef uint64_t Bitboard;
+
+// A single jump on a given board shape, with its masks precomputed
+struct Jump {
+    int from;
+    int over;
+    int to;
+    Bitboard fromOver;  // from | over, both must hold marbles
+    Bitboard toMask;    // destination, must be empty
+    Bitboard mask;      // from | over | to, XOR applies (or undoes) the jump
+};
+
+inline bool canJump(Bitboard pegs, const Jump& jump) {
+    return (pegs & jump.fromOver) == jump.fromOver && !(pegs & jump.toMask);
+}
+
+inline Bitboard applyJump(Bitboard pegs, const Jump& jump) {
+    return pegs ^ jump.mask;
+}
+
+// Reverse of a jump ("unjump"): the marble at `to` jumps back to `from`,
+// restoring the marble at `over`
+inline bool canUnjump(Bitboard pegs, const Jump& jump) {
+    return (pegs & jump.toMask) && !(pegs & jump.fromOver);
+}
+
+inline int popCount(Bitboard bits) {
+    return __builtin_popcountll(bits);
+}
+
+inline int lowestBit(Bitboard bits) {
+    return __builtin_ctzll(bits);
+}
+
+// Geometry of a board: which holes exist, every possible jump and the
+// symmetries of the layout. Shared read-only by all search code.
+class BoardShape {
+public:
+    static const int MAX_SYMMETRIES = 8;
+    static const int ALL_SYMMETRIES = (1 << MAX_SYMMETRIES) - 1;
+
+    // Same cross layout MarbleSolitaire::initializeBoard() builds
+    static BoardShape cross(int size);
+    static BoardShape english();
+    static BoardShape french();
+
+    const std::string& getName() const { return name; }
+    int getSize() const { return size; }
+    Bitboard getHoles() const { return holes; }
+    int getHoleCount() const { return popCount(holes); }
+    int getCenter() const { return index(size / 2, size / 2); }
+
+    int index(int row, int col) const { return row * size + col; }
+    Position position(int index) const { return Position(index / size, index % size); }
+    bool isHole(int row, int col) const;
+
+    // Jumps are identified by their index in this list
+    const std::vector<Jump>& getJumps() const { return jumps; }
+    const std::vector<int>& jumpsFrom(int hole) const { return jumpsByFrom[hole]; }
+    int findJump(int from, int to) const;
+    int findJump(const Move& move) const { return findJump(index(move.from.row, move.from.col), index(move.to.row, move.to.col)); }
+    int jumpBetween(Bitboard before, Bitboard after) const;
+    Move toMove(int jumpId) const;
+
+    // Jump ids playable forwards, or backwards as unjumps, on a board
+    void legalJumps(Bitboard pegs, std::vector<int>& out) const;
+    void legalUnjumps(Bitboard pegs, std::vector<int>& out) const;
+
+    // Holes no jump can pass over; a marble there can only leave by moving itself
+    Bitboard getCorners() const { return corners; }
+
+    // Every hole filled except the centre, as at the start of a game
+    Bitboard startPosition() const;
+    Bitboard fromGame(const MarbleSolitaire& game) const;
+
+    // Symmetry handling. symmetryMask selects which of the eight square
+    // symmetries may be used; only those preserving the layout are applied.
+    int getSymmetryMask() const { return validSymmetries; }
+    int stabilizer(Bitboard pattern) const;
+    Bitboard transform(Bitboard pegs, int sym) const;
+    Bitboard canonical(Bitboard pegs, int symmetryMask = ALL_SYMMETRIES) const;
+    int transformHole(int hole, int sym) const;
+
+    // Position class: a value every jump preserves, so two boards with
+    // different classes can never be reached from one another
+    int positionClass(Bitboard pegs) const;
+
+    std::string toString(Bitboard pegs) const;
+
+private:
+    BoardShape(const std::string& name, int size, Bitboard holes);
+    void buildJumps();
+    void buildSymmetries();
+
+    std::string name;
+    int size;
+    Bitboard holes;
+    Bitboard corners;
+    std::vector<Jump> jumps;
+    std::vector<std::vector<int>> jumpsByFrom;
+    int validSymmetries;
+    std::vector<int> holeMap;             // [sym * 64 + hole]
+    std::vector<Bitboard> byteTables;     // [(sym * 8 + byte) * 256 + value]
+    Bitboard diagonals[2][3];             // holes by (row + col) % 3 and (row - col) % 3
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "bitboard.h"
+#include "game.h"
+#include "move_evaluator.h"
+#include "theme.h"
+
+// One quad of the board, drawn instanced over the unit quad: attribute 1 is
+// (center, size, depth) and attribute 2 the colour, as instance.vs expects.
+// Cells, marbles, highlights, overlay rings and animated marbles all use it.
+struct QuadInstance {
+    glm::vec2 center;
+    float size;
+    float depth;
+    glm::vec4 color;
+};
+
+// Flags of one board texel, read by board.fs: one texel per hole
+enum BoardTexel {
+    TEXEL_HOLE = 1,       // Part of the board
+    TEXEL_MARBLE = 2,
+    TEXEL_SELECTED = 4,
+    TEXEL_HINT = 8        // One end of the hinted jump
+};
+
+// The texels that changed since the previous build, as one rectangle
+struct TexelRect {
+    int x = 0, y = 0, width = 0, height = 0;
+
+    bool empty() const { return width <= 0 || height <= 0; }
+};
+
+// The CPU side of drawing the board: every instance renderBoard() and
+// renderMarbles() upload, worked out without a single OpenGL call so it can
+// be benchmarked headless. The buffers keep their capacity between frames,
+// so rebuilding does not allocate.
+class BoardLayout {
+public:
+    BoardLayout();
+
+    // Only the cells inside `region` when given, as the low-cost tier redraws them
+    void buildCells(const MarbleSolitaire& game, const Theme& theme, const TexelRect* region = nullptr);
+    void buildMarbles(const MarbleSolitaire& game, const Theme& theme, const TexelRect* region = nullptr);
+    // Squares a little larger than the cell, one per position
+    void buildHighlights(const MarbleSolitaire& game, const Theme& theme, const Position* positions, int count,
+                         const glm::vec4& color);
+
+    // With a marble selected, one ring per destination it can jump to;
+    // otherwise one per movable marble, for the best of its jumps
+    void buildMoveOverlay(const MarbleSolitaire& game, const Theme& theme, const BoardShape& shape,
+                          const std::vector<MoveEvaluation>& evaluations);
+
+    // The whole board as boardSize x boardSize texels for the fullscreen board
+    // pass. Only the rectangle around texels that differ from the last build
+    // is marked dirty, so a move re-uploads a handful of texels.
+    void buildTexels(const MarbleSolitaire& game, const Move& hint);
+
+    // Marbles still being animated into these cells are left out of the
+    // builds above until their animation ends
+    void setHiddenCells(const std::vector<Position>& cells) { hiddenCells.assign(cells.begin(), cells.end()); }
+    bool isHidden(int row, int col) const;
+
+    const std::vector<QuadInstance>& getCells() const { return cells; }
+    const std::vector<QuadInstance>& getMarbles() const { return marbles; }
+    const std::vector<QuadInstance>& getHighlights() const { return highlights; }
+    const std::vector<QuadInstance>& getOverlay() const { return overlay; }
+    const std::vector<uint8_t>& getTexels() const { return texels; }
+    int getTexelSize() const { return texelSize; }
+    const TexelRect& getDirtyTexels() const { return dirtyTexels; }
+
+    // The lit marble of marble.fs, precomputed as size x size RG texels:
+    // brightness / 2 (it peaks above 1) and coverage, 0 outside the circle
+    static void buildMarbleSprite(int size, std::vector<uint8_t>& texels);
+
+    // Centre of a cell in normalised device coordinates
+    static glm::vec2 cellCenter(const MarbleSolitaire& game, const Theme& theme, int row, int col);
+
+private:
+    std::vector<QuadInstance> cells;
+    std::vector<QuadInstance> marbles;
+    std::vector<QuadInstance> highlights;
+    std::vector<QuadInstance> overlay;
+    std::vector<int> ringAt;                // Overlay index by hole, -1 for none
+    std::vector<MoveQuality> best;          // Best verdict and count behind each ring
+    std::vector<SolutionCount> bestCount;
+    std::vector<uint8_t> texels;            // Row-major, row 0 at the top
+    int texelSize;
+    TexelRect dirtyTexels;
+    std::vector<Position> hiddenCells;      // A few at most, so searched in order
+};
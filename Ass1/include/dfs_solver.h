@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.h"
+#include "move_ordering.h"
+#include "search_state.h"
+#include "transposition_table.h"
+
+struct DfsResult {
+    bool solved = false;
+    bool aborted = false;           // Node limit reached before an answer
+    std::vector<int> line;          // Jump ids from the start to the goal
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+};
+
+// Depth-first solver to a single marble, one jump per ply. Positions shown
+// to be dead ends are remembered in a transposition table, so the amount of
+// work depends almost entirely on how soon the move ordering finds a line.
+class DfsSolver {
+public:
+    DfsSolver(const BoardShape& shape, MoveOrderer& orderer, size_t tableMegabytes = 64);
+
+    // goalHole < 0 accepts a single marble anywhere; maxNodes 0 means no limit
+    DfsResult solve(Bitboard start, int goalHole = -1, uint64_t maxNodes = 0);
+
+private:
+    // Returns the fewest marbles left anywhere below `state`
+    int search(const BoardState& state);
+
+    const BoardShape& shape;
+    MoveOrderer& orderer;
+    TranspositionTable table;
+    Bitboard goalMask;
+    int symmetryMask;
+    uint64_t nodes;
+    uint64_t maxNodes;
+    bool solved;
+
+    Arena arena;
+    FlatStack<int> jumps;   // Legal jumps of every ply on the current line
+    FlatStack<int> line;
+};
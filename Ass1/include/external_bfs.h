@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+
+// Sorted board files are stored as LEB128 varints of the difference to the
+// previous board, which typically needs 2-4 bytes per position
+class BoardRunWriter {
+public:
+    BoardRunWriter(const std::string& path, size_t bufferBytes);
+    ~BoardRunWriter();
+
+    bool isOpen() const { return file != nullptr; }
+    void write(Bitboard pegs);   // Must be called in increasing order
+    bool close();
+    uint64_t getCount() const { return count; }
+
+private:
+    void flush();
+
+    std::FILE* file;
+    std::vector<unsigned char> buffer;
+    size_t used;
+    Bitboard previous;
+    uint64_t count;
+};
+
+class BoardRunReader {
+public:
+    BoardRunReader(const std::string& path, size_t bufferBytes);
+    ~BoardRunReader();
+
+    bool isOpen() const { return file != nullptr; }
+    bool next(Bitboard& pegs);
+    // A read error or a truncated run ended next() early, not the end of the file
+    bool failed() const { return error; }
+
+private:
+    bool fill();
+
+    std::FILE* file;
+    std::vector<unsigned char> buffer;
+    size_t used;
+    size_t available;
+    Bitboard previous;
+    bool error;
+};
+
+struct ExternalBfsConfig {
+    std::string directory = "bfs";
+    size_t memoryBytes = size_t(256) << 20;   // Bound on buffers and the in-memory run
+    size_t ioBufferBytes = size_t(1) << 20;   // Per open file
+    bool useSymmetry = true;
+};
+
+// Disk-backed breadth-first enumeration of every position reachable from a
+// start, one peg-count layer at a time. Successors of a layer are collected
+// into memory-sized sorted runs, then k-way merged (dropping duplicates) into
+// the next layer file. A checkpoint file records finished layers so an
+// interrupted enumeration picks up where it stopped.
+class ExternalBfs {
+public:
+    ExternalBfs(const BoardShape& shape, const ExternalBfsConfig& config);
+
+    bool run(Bitboard start);
+
+    // Positions per peg count, filled in for every finished layer
+    const std::vector<uint64_t>& getLayerCounts() const { return layerCounts; }
+
+private:
+    std::string layerPath(int pegs) const;
+    std::string runPath(int pegs, int run) const;
+    std::string checkpointPath() const;
+
+    bool loadCheckpoint(Bitboard start, int& lastLayer);
+    bool saveCheckpoint(Bitboard start, int lastLayer);
+    bool writeStartLayer(Bitboard start);
+    bool expandLayer(int pegs, std::vector<std::string>& runs);
+    bool writeRun(std::vector<Bitboard>& boards, const std::string& path);
+    bool mergeRuns(const std::vector<std::string>& runs, const std::string& output, uint64_t& count);
+    // One k-way merge; deletes the runs once all of them reached the output
+    bool mergeGroup(const std::vector<std::string>& runs, const std::string& output, uint64_t& count);
+
+    const BoardShape& shape;
+    ExternalBfsConfig config;
+    int symmetryMask;
+    std::vector<uint64_t> layerCounts;
+};
@@ -34,6 +34,18 @@ struct Move {
         : from(f), to(t), jumped(j) {}
 };
 
+enum MoveEventKind {
+    MOVE_PLAYED,    // A jump or a redo: the marble went from move.from to move.to
+    MOVE_UNDONE,    // The marble went back to move.from and move.jumped returned
+    BOARD_RESET
+};
+
+// A board change for observers that draw it over time, like the animator
+struct MoveEvent {
+    MoveEventKind kind;
+    Move move;
+};
+
 class MarbleSolitaire {
 public:
     MarbleSolitaire(int boardSize = 7);
@@ -70,6 +82,11 @@ public:
     bool undoMove();
     bool redoMove();
 
+    // Move events are only queued once asked for, so headless callers pay nothing
+    void setRecordMoveEvents(bool value) { recordMoveEvents = value; moveEvents.clear(); }
+    // Every board change since the last call, oldest first
+    void takeMoveEvents(std::vector<MoveEvent>& out);
+
     // Game state checks
     bool gameOver() const;
     bool hasWon() const;
@@ -89,9 +106,12 @@ private:
     std::stack<Move> moveHistory;
     std::stack<Move> redoStack;
     std::chrono::time_point<std::chrono::system_clock> startTime;
+    bool recordMoveEvents;
+    std::vector<MoveEvent> moveEvents;
 
     bool isValidPosition(const Position& pos) const;
     Position getJumpedPosition(const Position& from, const Position& to) const;
     bool hasValidMoves() const;
     void initializeBoard();
+    void recordEvent(MoveEventKind kind, const Move& move);
 };
\ No newline at end of file
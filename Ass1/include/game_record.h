@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+
+// Board shapes a record can be played on
+enum RecordShape {
+    RECORD_ENGLISH = 0,
+    RECORD_FRENCH = 1
+};
+
+bool recordShapeFor(const BoardShape& shape, uint8_t& id);
+BoardShape shapeForRecord(uint8_t id);
+
+// Fixed part of one game record, followed on disk by `jumps` bytes, one jump
+// id (BoardShape::getJumps() index) per jump played. Host byte order.
+struct GameRecordHeader {
+    uint8_t shape;
+    uint8_t jumps;
+    uint16_t reserved;
+    uint32_t durationMillis;
+    uint64_t start;             // Bitboard of the starting position
+    uint64_t seed;              // Seed of whatever produced the game, 0 if none
+    int64_t startMillis;        // Unix time the game started, in milliseconds
+};
+static_assert(sizeof(GameRecordHeader) == 32, "game records are written as raw 32-byte headers");
+
+// A record file ("MSGR") is a short file header and records back to back.
+// Next to it, path + ".idx" ("MSGI") holds the byte offset of every record,
+// so record N is found in O(1). Both files are only ever appended to, except
+// that opening them cuts off a torn record or index entry left by a crash.
+class GameRecordWriter {
+public:
+    explicit GameRecordWriter(const std::string& path);
+    ~GameRecordWriter();
+
+    bool isOpen() const { return data && index; }
+
+    // Safe to call from several threads at once
+    bool append(const GameRecordHeader& header, const uint8_t* jumps);
+    bool close();
+
+    uint64_t getCount() const { return count; }
+
+private:
+    GameRecordWriter(const GameRecordWriter&);
+    GameRecordWriter& operator=(const GameRecordWriter&);
+
+    std::FILE* data;
+    std::FILE* index;
+    uint64_t offset;            // Where the next record starts
+    uint64_t count;             // Records in the file, including earlier sessions
+    bool failed;
+    std::mutex lock;
+};
+
+// One record inside the mapped file: its header copied out, its jumps in place
+struct GameRecordView {
+    GameRecordHeader header;
+    const uint8_t* jumps;
+};
+
+// Memory-mapped reader. Records come from the index in O(1) or from a
+// sequential scan; validate() replays a record on the bitboard engine.
+// A record or index entry cut short by a crash is ignored.
+class GameRecordReader {
+public:
+    explicit GameRecordReader(const std::string& path);
+    ~GameRecordReader();
+
+    bool isOpen() const { return data != nullptr; }
+    bool hasIndex() const { return offsets != nullptr; }
+    uint64_t getCount() const { return count; }
+
+    // Record n, through the index (or offsets found by a scan without one)
+    bool get(uint64_t n, GameRecordView& view) const;
+
+    // Sequential scan from the first record
+    void rewind() { cursor = HEADER_BYTES; }
+    bool next(GameRecordView& view);
+
+    // Replays the jumps from the start position: every jump must be legal.
+    // On success, pegs holds the final position.
+    bool validate(const GameRecordView& view, Bitboard& pegs) const;
+
+    static const size_t HEADER_BYTES = 8;
+
+private:
+    GameRecordReader(const GameRecordReader&);
+    GameRecordReader& operator=(const GameRecordReader&);
+
+    bool readAt(uint64_t offset, GameRecordView& view) const;
+
+    const uint8_t* data;
+    size_t dataBytes;
+    const uint64_t* offsets;    // Into the mapped index, past its header
+    size_t indexBytes;
+    const uint8_t* indexMapping;
+    std::vector<uint64_t> scanned;  // Offsets found by scanning when there is no index
+    uint64_t count;
+    uint64_t cursor;
+    BoardShape shapes[2];
+};
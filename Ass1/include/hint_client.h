@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "hint_protocol.h"
+
+// Client side of the hint protocol. Requests can be pipelined: send() any
+// number of them, then collect responses (matched by id) with receive() or,
+// from a render loop that must not stall, with poll().
+class HintClient {
+public:
+    HintClient();
+    ~HintClient();
+
+    bool connect(const std::string& socketPath);
+    bool isConnected() const { return fd >= 0; }
+    void disconnect();
+
+    bool send(const HintRequest& request);
+    bool send(const std::vector<HintRequest>& requests);
+
+    // Blocks until one response is complete; false once the connection is gone
+    bool receive(HintResponse& response);
+    // Returns at once; true only when a whole response was waiting
+    bool poll(HintResponse& response);
+
+    // One request, waiting for its answer
+    bool query(const HintRequest& request, HintResponse& response);
+
+private:
+    bool takeResponse(HintResponse& response);
+    bool readSome(bool wait);
+
+    int fd;
+    std::vector<uint8_t> input;   // Received bytes not yet handed out
+    size_t consumed;
+
+    HintClient(const HintClient&);
+    HintClient& operator=(const HintClient&);
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+// Binary protocol of the hint service, host byte order (the socket is local).
+// A client writes fixed 16-byte requests and may pipeline as many as it likes;
+// every request gets exactly one response, a 24-byte header followed by
+// `jumps` jump ids. Responses on a connection may arrive out of order, so
+// clients match them by id.
+
+enum HintOp {
+    HINT_OP_SOLVE = 1,          // Whole line down to one marble
+    HINT_OP_HINT = 2,           // First jump of such a line
+    HINT_OP_IS_SOLVABLE = 3,    // count = 1 if one marble can be reached, else 0
+    HINT_OP_COUNT = 4           // count = number of winning jump sequences
+};
+
+enum HintStatus {
+    HINT_OK = 0,
+    HINT_UNSOLVABLE = 1,        // Solve or hint on a position that cannot be won
+    HINT_BAD_REQUEST = 2        // Unknown op or shape, or marbles off the board
+};
+
+struct HintRequest {
+    uint32_t id;
+    uint8_t op;
+    uint8_t shape;              // RecordShape: 0 English, 1 French
+    uint16_t reserved;
+    uint64_t pegs;
+};
+static_assert(sizeof(HintRequest) == 16, "requests travel as raw 16-byte structs");
+
+// Where the daemon listens and front ends look unless told otherwise
+const char* const HINT_DEFAULT_SOCKET = "/tmp/marble_solitaire.sock";
+
+const int HINT_MAX_JUMPS = 64;
+const int HINT_RESPONSE_HEADER = 24;
+
+struct HintResponse {
+    uint32_t id;
+    uint8_t op;
+    uint8_t status;
+    uint8_t jumps;              // Jump ids that follow the header
+    uint8_t reserved;
+    uint64_t countLow;
+    uint64_t countHigh;
+    uint8_t line[HINT_MAX_JUMPS];
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+#include "hint_protocol.h"
+#include "opening_book.h"
+#include "solution_counter.h"
+#include "solvability.h"
+
+// Answers hint protocol queries from caches that stay warm for as long as
+// the service runs: a solvability table and a solution-count memo per board
+// shape. Any number of threads may call answer() at once.
+class HintService {
+public:
+    HintService(size_t tableMegabytes, size_t memoMegabytes);
+
+    void answer(const HintRequest& request, HintResponse& response);
+
+    // Opening positions are then answered from the book; not owned
+    bool setBook(const OpeningBook* book);
+
+private:
+    struct Board {
+        SolvabilityOracle oracle;
+        std::unique_ptr<SolutionCounter> counter;    // Created on the first count query
+        std::once_flag counterCreated;
+        const OpeningBook* book = nullptr;
+        std::atomic<int64_t> agedAt;   // Steady clock milliseconds of the last newSearch()
+
+        Board(const BoardShape& shape, size_t tableMegabytes) : oracle(shape, tableMegabytes), agedAt(0) {}
+    };
+
+    void age(Board& board);
+
+    size_t memoMegabytes;
+    std::unique_ptr<Board> boards[2];
+};
+
+struct HintServerStats {
+    uint64_t requests = 0;
+    uint64_t batches = 0;
+    uint64_t deduplicated = 0;  // Requests answered from another in the same batch
+    uint64_t connections = 0;
+};
+
+// Unix domain socket front end. One thread polls the listening socket and
+// every connection, queueing complete requests; a pool of workers takes
+// them in batches, answers repeated queries in a batch only once, and
+// writes each connection's responses with a single send.
+class HintServer {
+public:
+    HintServer(HintService& service, const std::string& socketPath, int threads, size_t batchSize);
+    ~HintServer();
+
+    // Serves until stop() is called or SIGINT/SIGTERM arrives
+    bool run();
+    void stop() { stopping = true; }
+
+    HintServerStats getStats() const;
+
+private:
+    struct Connection {
+        int fd;
+        std::mutex writeLock;
+        std::vector<uint8_t> input;     // Bytes of a request not yet complete
+        std::atomic<bool> closed;       // A read or a send failed: nothing more is written
+
+        explicit Connection(int socket) : fd(socket), closed(false) {}
+        ~Connection();
+    };
+
+    struct Pending {
+        std::shared_ptr<Connection> connection;
+        HintRequest request;
+    };
+
+    void worker();
+    void process(std::vector<Pending>& batch, std::vector<HintResponse>& responses);
+    bool readFrom(const std::shared_ptr<Connection>& connection);
+
+    HintService& service;
+    std::string path;
+    int threads;
+    size_t batchSize;
+    int listener;
+    std::atomic<bool> stopping;
+
+    std::mutex queueLock;
+    std::condition_variable queueReady;
+    std::deque<Pending> queue;
+
+    std::atomic<uint64_t> requests, batches, deduplicated, connections;
+};
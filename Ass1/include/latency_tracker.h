@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Where the time between an input and the frame that shows it goes
+enum LatencyStage {
+    STAGE_POLLING = 0,  // From the previous glfwPollEvents to the callback: the longest
+                        // the event can have waited in the queue
+    STAGE_LOGIC,        // The callback: processClick, undo, redo... up to the game state change
+    STAGE_QUEUED,       // From the state change to renderGame starting
+    STAGE_RENDER,       // renderGame
+    STAGE_UI,           // Hints, move overlay and ImGui, up to glfwSwapBuffers
+    STAGE_SWAP,         // glfwSwapBuffers, including any wait for vsync
+    STAGE_GPU,          // The fence wait after the swap, when enabled
+    STAGE_COUNT
+};
+
+// Points of the main loop's frame, in the order they happen
+enum FrameMark {
+    MARK_POLL_END = 0,
+    MARK_RENDER_START,
+    MARK_RENDER_END,
+    MARK_SWAP_START,
+    MARK_SWAP_END,
+    MARK_COUNT
+};
+
+const int LATENCY_HISTOGRAM_BINS = 100;
+const float LATENCY_BIN_MILLISECONDS = 1.0f;   // The last bin also takes everything slower
+
+// One input, from its GLFW callback to the end of the frame that drew it
+struct LatencySample {
+    double inputSeconds;            // Since the tracker started
+    const char* source;             // "click", "key"...
+    bool changedState;
+    float stages[STAGE_COUNT];      // Milliseconds
+    float total;                    // Callback to end of frame, polling excluded
+};
+
+// Input-to-photon latency of the game window, without a single OpenGL call.
+// Callbacks open a sample for every press; the main loop marks its frame on a
+// monotonic clock, and the end of the frame closes every open sample with the
+// same marks, as the frame is the first to show their effect. Totals go into
+// a fixed histogram as they arrive, so the live view costs nothing to update.
+class LatencyTracker {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    LatencyTracker();
+
+    // From an input callback, before and after handling the event
+    void inputReceived(const char* source);
+    void inputHandled(bool changedState);
+
+    void mark(FrameMark mark);
+    // After the swap and the optional GPU wait; closes the frame's samples
+    void endFrame(bool waitedForGpu);
+
+    void clear();
+
+    const std::vector<LatencySample>& getSamples() const { return samples; }
+    const float* getHistogram() const { return histogram; }
+    float getStageMean(LatencyStage stage) const;
+    float getStageMax(LatencyStage stage) const { return stageMax[stage]; }
+    // Read from the histogram, so to the nearest bin
+    float getTotalPercentile(float fraction) const;
+
+    static const char* stageName(LatencyStage stage);
+
+    // One row per input, stages in milliseconds
+    bool writeCsv(const std::string& path) const;
+
+private:
+    struct PendingInput {
+        const char* source;
+        Clock::time_point lastPoll;
+        Clock::time_point received;
+        Clock::time_point handled;
+        bool changedState;
+    };
+
+    static float milliseconds(Clock::time_point from, Clock::time_point to);
+
+    Clock::time_point started;
+    Clock::time_point marks[MARK_COUNT];
+    std::vector<PendingInput> pending;
+    std::vector<LatencySample> samples;
+    float histogram[LATENCY_HISTOGRAM_BINS];   // Float, as ImGui::PlotHistogram takes it
+    double stageSum[STAGE_COUNT];
+    float stageMax[STAGE_COUNT];
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "bitboard.h"
+
+struct MctsConfig {
+    uint64_t iterations = 100000;   // Across all threads; 0 means no limit
+    int milliseconds = 0;           // 0 means no limit
+    int threads = 1;                // One independent tree per thread
+    double exploration = 0.5;       // UCT constant for rewards in [0, 1]
+    double bestWeight = 0.5;        // Blend of the best rollout below a node into its mean
+    size_t poolNodes = 1 << 20;     // Node pool per tree
+    uint64_t seed = 1;
+};
+
+struct MctsResult {
+    int bestJump = -1;              // Jump to play: first of the best rollout line
+    uint64_t bestJumpVisits = 0;    // Root statistics of that jump
+    double bestJumpValue = 0.0;     // Mean reward through that jump
+    std::vector<int> principalLine; // Most visited path through the tree
+    std::vector<int> bestRollout;   // Full line of the rollout that left the fewest marbles
+    int bestRolloutPegs = 0;
+    uint64_t rollouts = 0;
+    uint64_t nodes = 0;             // Pool nodes in use over all trees
+    double seconds = 0.0;
+
+    double rolloutsPerSecond() const { return seconds > 0.0 ? rollouts / seconds : 0.0; }
+};
+
+// Monte Carlo tree search player with UCT selection and random bitboard
+// rollouts. Rewards are the fraction of marbles removed, 1 for a win, and
+// selection blends each node's best reward into its mean, as suits a
+// single-player game. The player follows the line of the best rollout, which
+// carries over to the next search when the game follows it.
+// Trees live in node pools reserved up front, so searching never allocates.
+// Several threads each grow their own tree (root parallelism) and the root
+// statistics are summed; trees share nothing, so no locks or virtual loss
+// are needed.
+class MctsPlayer {
+public:
+    MctsPlayer(const BoardShape& shape, const MctsConfig& config);
+
+    // Full search with every configured thread, within the configured budgets
+    MctsResult search(Bitboard pegs);
+
+    // Incremental search on a single tree, for running inside a frame loop
+    void start(Bitboard pegs);
+    void step(uint64_t iterations, int microseconds);
+    Bitboard getRoot() const { return root; }
+    void setSeed(uint64_t value) { config.seed = value; }
+
+    // Statistics of the trees grown since the last start() or search()
+    MctsResult getResult() const;
+    int getBestJump() const;
+
+private:
+    struct Node {
+        Bitboard pegs;
+        int32_t parent;
+        int32_t firstChild;     // -1 until expanded
+        uint32_t visits;
+        uint16_t childCount;
+        int16_t jump;           // Jump that led here from the parent
+        double totalReward;
+        float bestReward;
+    };
+
+    struct Tree {
+        std::vector<Node> nodes;
+        size_t used;
+        std::mt19937_64 rng;
+        uint64_t rollouts;
+        int bestPegs;
+        std::vector<int> bestLine;
+        double seconds;
+    };
+
+    void reset(Tree& tree, uint64_t seed);
+    void grow(Tree& tree, uint64_t iterations, int microseconds);
+    void iterate(Tree& tree, int* line);
+    bool expand(Tree& tree, int32_t node);
+    const std::vector<int>* bestLine(int& pegs) const;
+    void carryOver(Bitboard pegs);
+
+    const BoardShape& shape;
+    MctsConfig config;
+    Bitboard root;
+    int rootPegs;
+    std::vector<Tree> trees;
+    size_t activeTrees;
+    std::vector<int> carried;   // Rest of the previous best line, if still on it
+    int carriedPegs;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "bitboard.h"
+#include "search_state.h"
+#include "transposition_table.h"
+
+// A chain of jumps by one marble, counted as a single move.
+// Holds every hole the marble visits, starting with where it was picked up.
+typedef std::vector<Position> MoveChain;
+
+struct MinMoveResult {
+    bool solved = false;
+    int moves = 0;                  // Number of chains in the optimal line
+    std::vector<MoveChain> line;
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+    uint64_t searchAllocations = 0;  // Heap allocations while searching, expected to be zero
+
+    double nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+};
+
+// Optimal solver for the "multi-jump" metric, where consecutive jumps by the
+// same marble count as one move. Uses iterative-deepening A* with the
+// corner-peg lower bound and a transposition table of failed budgets.
+// All per-node storage comes from an arena reserved once per solver.
+class MinMoveSolver {
+public:
+    explicit MinMoveSolver(const BoardShape& shape, size_t tableMegabytes = 256,
+                           ReplacementPolicy policy = REPLACE_DEPTH_PREFERRED, bool hugePages = false);
+
+    // goalHole < 0 accepts a single marble anywhere on the board
+    MinMoveResult solve(Bitboard start, int goalHole = -1, int maxMoves = 64);
+
+    // Admissible lower bound on the moves still needed
+    int lowerBound(Bitboard pegs) const;
+
+    void setVerbose(bool value) { verbose = value; }
+    const TranspositionTable& getTable() const { return table; }
+
+private:
+    struct Child {
+        BoardState state;
+        int bound;
+    };
+
+    // Flat stack sizes: plenty for every board that fits a Bitboard
+    static const size_t MAX_CHILDREN = 1 << 16;
+
+    bool search(const BoardState& state, int budget);
+    void generateChains(Bitboard pegs, size_t start, int hole);
+    MoveChain findChain(Bitboard from, Bitboard to) const;
+    bool isGoal(Bitboard pegs) const;
+
+    const BoardShape& shape;
+    TranspositionTable table;
+    Bitboard goalMask;
+    int symmetryMask;
+    uint64_t nodes;
+    bool verbose;
+    bool overflow;
+
+    Arena arena;
+    FlatStack<Child> children;   // Moves of every ply on the current line
+    FlatStack<Bitboard> path;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bitboard.h"
+#include "opening_book.h"
+#include "solution_counter.h"
+#include "solvability.h"
+
+enum MoveQuality {
+    MOVE_PENDING,   // Not evaluated yet
+    MOVE_WINNABLE,  // One marble can still be reached after this jump
+    MOVE_DEAD       // Every line after this jump leaves two marbles or more
+};
+
+struct MoveEvaluation {
+    int jump = -1;
+    MoveQuality quality = MOVE_PENDING;
+    bool counted = false;
+    SolutionCount solutions = 0;    // Winning jump sequences after the jump, when counted
+};
+
+struct MoveEvaluatorConfig {
+    int threads = 0;                // 0: one per core, less the render thread
+    size_t tableMegabytes = 256;
+    size_t memoMegabytes = 256;
+    int countBelowPegs = 16;        // Exact counts only where they are cheap
+};
+
+// Judges every legal jump of a position on a pool of worker threads, so an
+// interactive front end can colour each move without stalling a frame.
+// evaluate() returns at once; results arrive one jump at a time and can be
+// collected every frame. The solvability cache, the count memo and the
+// optional opening book persist, so later positions in a game are cheap.
+class MoveEvaluator {
+public:
+    explicit MoveEvaluator(const BoardShape& shape, const MoveEvaluatorConfig& config = MoveEvaluatorConfig());
+    ~MoveEvaluator();
+
+    // Not owned; set before the first evaluate()
+    void setBook(const OpeningBook* openingBook);
+
+    // Drops whatever was being evaluated and starts on this position
+    void evaluate(Bitboard pegs);
+    Bitboard getPosition() const;
+
+    // Copies the evaluations so far; true once every jump has one
+    bool getResults(std::vector<MoveEvaluation>& out) const;
+
+    // Time from evaluate() to the last result, or so far if still running
+    double getSeconds() const;
+
+    const BoardShape& getShape() const { return oracle.getShape(); }
+    int getThreads() const { return static_cast<int>(workers.size()); }
+
+private:
+    MoveEvaluator(const MoveEvaluator&);
+    MoveEvaluator& operator=(const MoveEvaluator&);
+
+    void worker();
+    MoveEvaluation judge(int jump, Bitboard after);
+
+    SolvabilityOracle oracle;
+    std::unique_ptr<SolutionCounter> counter;
+    const OpeningBook* book;
+    int countBelowPegs;
+
+    mutable std::mutex lock;
+    std::condition_variable wake;
+    std::vector<MoveEvaluation> results;   // One per legal jump of the position
+    size_t nextTask;
+    size_t finished;
+    uint64_t generation;                   // Bumped by evaluate(), so stale answers are dropped
+    Bitboard position;
+    bool stopping;
+    std::chrono::steady_clock::time_point started;
+    double seconds;
+
+    std::vector<std::thread> workers;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+#include "search_state.h"
+
+// Pluggable move ordering for the depth-first engine. Subclasses score each
+// legal jump; order() then sorts best first, keeping the board's fixed
+// up/down/left/right order between equal scores.
+class MoveOrderer {
+public:
+    explicit MoveOrderer(const BoardShape& boardShape) : shape(boardShape) {}
+    virtual ~MoveOrderer() {}
+
+    virtual const char* getName() const = 0;
+
+    // Forget everything learned in a previous search
+    virtual void reset() {}
+
+    // Sorts the legal jump ids of `state` in place, best first
+    void order(const BoardState& state, int* jumps, int count);
+
+    // The hooks order() is built on: prepare() once per position, then
+    // score() for every legal jump, higher is better
+    virtual void prepare(const BoardState& state) {}
+    virtual int64_t score(const BoardState& state, int jumpId) = 0;
+
+    // Feedback once a jump has been searched: `fewestPegs` is the fewest
+    // marbles left anywhere below it (1 when it led to a solution)
+    virtual void searched(int depth, int jumpId, int fewestPegs) {}
+
+    // "fixed", "history", "killer", "mobility" or "combined"; nullptr if unknown
+    static std::unique_ptr<MoveOrderer> create(const BoardShape& shape, const std::string& name);
+    static std::vector<std::string> names();
+
+protected:
+    const BoardShape& shape;
+};
+
+// Keeps the order jumps are generated in
+class FixedOrderer : public MoveOrderer {
+public:
+    explicit FixedOrderer(const BoardShape& shape) : MoveOrderer(shape) {}
+    const char* getName() const { return "fixed"; }
+    int64_t score(const BoardState&, int) { return 0; }
+};
+
+// Jumps that came close to a solution anywhere in the tree are tried first
+class HistoryOrderer : public MoveOrderer {
+public:
+    explicit HistoryOrderer(const BoardShape& shape);
+    const char* getName() const { return "history"; }
+    void reset();
+    void searched(int depth, int jumpId, int fewestPegs);
+    int64_t score(const BoardState&, int jumpId) { return history[jumpId]; }
+
+private:
+    std::vector<int64_t> history;   // Indexed by jump id
+};
+
+// Per depth, the two jumps that most recently got furthest among their siblings
+class KillerOrderer : public MoveOrderer {
+public:
+    explicit KillerOrderer(const BoardShape& shape) : MoveOrderer(shape) { reset(); }
+    const char* getName() const { return "killer"; }
+    void reset();
+    void searched(int depth, int jumpId, int fewestPegs);
+    void prepare(const BoardState& state);
+    int64_t score(const BoardState& state, int jumpId);
+
+private:
+    static const int MAX_DEPTH = 64;
+
+    int killers[MAX_DEPTH][2];
+    int bestPegs[MAX_DEPTH];    // Best sibling so far at the node being searched
+};
+
+// Prefers jumps that leave many follow-up jumps and land near the centre
+class MobilityOrderer : public MoveOrderer {
+public:
+    explicit MobilityOrderer(const BoardShape& shape) : MoveOrderer(shape) {}
+    const char* getName() const { return "mobility"; }
+    int64_t score(const BoardState& state, int jumpId) { return mobility(state.pegs, jumpId); }
+
+    // Always between 0 and 255
+    int mobility(Bitboard pegs, int jumpId) const;
+};
+
+// Killer moves first, then history, with mobility breaking ties
+class CombinedOrderer : public MoveOrderer {
+public:
+    explicit CombinedOrderer(const BoardShape& shape)
+        : MoveOrderer(shape), history(shape), killer(shape), mobilityScore(shape) {}
+    const char* getName() const { return "combined"; }
+    void reset();
+    void searched(int depth, int jumpId, int fewestPegs);
+    void prepare(const BoardState& state) { killer.prepare(state); }
+    int64_t score(const BoardState& state, int jumpId);
+
+private:
+    HistoryOrderer history;
+    KillerOrderer killer;
+    MobilityOrderer mobilityScore;
+};
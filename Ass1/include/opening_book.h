@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "bitboard.h"
+#include "solution_counter.h"
+
+// One book position, in its canonical orientation. The best jump is stored
+// as holes rather than a jump id so it can be turned with the board.
+struct OpeningBookEntry {
+    uint64_t key;               // BoardShape::canonical() of the position
+    uint64_t countLow;          // Winning jump sequences, when the book has counts
+    uint64_t countHigh;
+    uint8_t solvable;
+    uint8_t bestFrom;           // Hole the best jump starts from, 0xFF if none
+    uint8_t bestTo;
+    uint8_t reserved[5];
+};
+static_assert(sizeof(OpeningBookEntry) == 32, "book entries are mapped as raw 32-byte structs");
+
+// File header ("MSOB"), followed by the entries sorted by key
+struct OpeningBookHeader {
+    char magic[4];
+    uint32_t version;
+    uint8_t shape;              // RecordShape
+    uint8_t plies;              // Every position this many jumps from the start is in the book
+    uint16_t flags;
+    uint32_t reserved;
+    uint64_t start;
+    uint64_t count;
+};
+static_assert(sizeof(OpeningBookHeader) == 32, "the book header is mapped as a raw 32-byte struct");
+
+const uint16_t BOOK_HAS_COUNTS = 1;
+
+struct OpeningBookHit {
+    bool solvable = false;
+    int bestJump = -1;          // Jump id for the position as asked, -1 if it cannot be won
+    bool counted = false;
+    SolutionCount solutions = 0;
+};
+
+struct OpeningBookConfig {
+    int plies = 10;
+    bool counts = false;        // Exact counts cost a full count from the start
+    int threads = 1;
+    size_t tableMegabytes = 2048;  // Below ~1 GB the English opening thrashes the table
+    size_t memoMegabytes = 1024;
+};
+
+// Precomputed answers for the opening: every position within a few jumps of
+// the start, with its solvability, best jump and optionally its solution
+// count. The file is memory-mapped and searched in place, so opening it
+// costs nothing and a lookup is one canonical() plus an interpolation
+// search. Read-only once open; any number of threads may look things up.
+class OpeningBook {
+public:
+    explicit OpeningBook(const std::string& path);
+    ~OpeningBook();
+
+    bool isOpen() const { return entries != nullptr; }
+    const BoardShape& getShape() const { return shape; }
+    uint64_t getCount() const { return count; }
+    int getPlies() const { return header ? header->plies : 0; }
+    Bitboard getStart() const { return header ? header->start : 0; }
+    bool hasCounts() const { return header && (header->flags & BOOK_HAS_COUNTS); }
+
+    // Any orientation of a book position; false when it is not in the book
+    bool lookup(Bitboard pegs, OpeningBookHit& hit) const;
+
+    // Enumerates the positions up to config.plies jumps from start, solves
+    // them and writes the sorted book
+    static bool build(const BoardShape& shape, Bitboard start, const OpeningBookConfig& config,
+                      const std::string& path);
+
+private:
+    OpeningBook(const OpeningBook&);
+    OpeningBook& operator=(const OpeningBook&);
+
+    const OpeningBookEntry* find(Bitboard key) const;
+
+    const uint8_t* mapping;
+    size_t bytes;
+    const OpeningBookHeader* header;
+    const OpeningBookEntry* entries;
+    uint64_t count;
+    BoardShape shape;
+};
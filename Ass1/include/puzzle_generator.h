@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "bitboard.h"
+
+// A worker gives up after this many candidates in a row are rejected
+const int PUZZLE_MAX_REJECTIONS = 1000;
+
+// A generated position, guaranteed solvable down to one marble
+struct Puzzle {
+    Bitboard pegs = 0;
+    int finishHole = -1;      // Hole the generating line finishes on
+    int difficulty = 0;       // floor(-log2) of the fraction of complete jump sequences that win
+    double solutions = 0.0;   // Number of jump sequences ending with one marble
+};
+
+struct PuzzleGeneratorConfig {
+    int pegs = 12;
+    uint64_t count = 1000;
+    uint64_t seed = 1;
+    int threads = 0;          // 0 uses every hardware thread
+    int minDifficulty = 0;
+    int maxDifficulty = 255;
+};
+
+// Appends puzzles to a compact binary file: a short header followed by
+// fixed 11-byte records (packed board, finish hole, marble count, difficulty).
+// Safe to call from several threads.
+class PuzzleWriter {
+public:
+    PuzzleWriter(const std::string& path, const BoardShape& shape);
+    ~PuzzleWriter();
+
+    bool isOpen() const { return out.is_open(); }
+    void write(const Puzzle& puzzle);
+    uint64_t getWritten() const { return written; }
+
+private:
+    std::ofstream out;
+    std::mutex mutex;
+    std::string buffer;
+    uint64_t written;
+};
+
+// Grows positions backwards from a single marble with random unjumps, so
+// every puzzle has at least one solution, then grades it by counting how
+// many of its jump sequences actually win.
+class PuzzleGenerator {
+public:
+    explicit PuzzleGenerator(const BoardShape& shape);
+
+    // Returns the number of puzzles written, fewer than asked for when every
+    // worker hit PUZZLE_MAX_REJECTIONS
+    uint64_t generate(const PuzzleGeneratorConfig& config, PuzzleWriter& writer);
+
+private:
+    struct Counts {
+        double total;  // Jump sequences played until no move is left
+        double wins;   // Of those, the ones ending with a single marble
+    };
+    typedef std::unordered_map<Bitboard, Counts> CountMemo;
+
+    void worker(int threadIndex, const PuzzleGeneratorConfig& config, PuzzleWriter& writer);
+    bool grow(Bitboard& pegs, int& finishHole, int targetPegs, std::mt19937_64& rng, std::vector<int>& scratch) const;
+    Counts count(Bitboard pegs, CountMemo& memo) const;
+    bool markSeen(Bitboard canonical);
+    bool reserveSlot(uint64_t limit);
+
+    const BoardShape& shape;
+    std::mutex mutex;
+    std::unordered_set<Bitboard> seen;   // Canonical boards already produced
+    uint64_t accepted;
+};
@@ -5,9 +5,35 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "animator.h"
+#include "bitboard.h"
+#include "board_layout.h"
 #include "game.h"
+#include "move_evaluator.h"
 #include "shader.h"
+#include "spectator_wall.h"
 #include "theme.h"
+
+// How the board and marbles are drawn
+enum BoardRenderMode {
+    BOARD_GEOMETRY,   // One quad per cell and per marble
+    BOARD_TEXTURE     // One texel per hole, one fullscreen pass; for huge boards
+};
+
+// How much work each frame may cost
+enum RenderQuality {
+    QUALITY_FULL,       // Lighting per fragment, the whole board redrawn every frame
+    QUALITY_LOW_COST    // For CPU rasterizers: sprite marbles, no discard, scaled, changed cells only
+};
+
+// One instanced stream over the unit quad: its vertex array and the
+// QuadInstance buffer, grown only when a frame needs more room
+struct InstanceBatch {
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    size_t capacity = 0;
+};
+
 class Renderer {
 public:
     Renderer(int windowWidth, int windowHeight);
@@ -23,7 +49,26 @@ public:
     void renderMarbles(const MarbleSolitaire& game);
     void renderSelection(const MarbleSolitaire& game);
     void renderGameInfo(const MarbleSolitaire& game);
+    void renderHint(const MarbleSolitaire& game, const Move& hint);
+    // Colour-coded rings from a MoveEvaluator, in one instanced draw
+    void renderMoveOverlay(const MarbleSolitaire& game, const BoardShape& shape,
+                           const std::vector<MoveEvaluation>& evaluations);
+    // Every board of a spectator wall in one instanced draw call; the snapshot
+    // is only uploaded when `changed`
+    void renderWall(const BoardShape& shape, const std::vector<WallBoard>& boards, bool changed);
+    // Copies the theme into the ThemeBlock buffer every shader reads; nothing
+    // theme-related is sent per draw, so switching costs one buffer upload
     void setTheme(const Theme& theme);
+    // The low-cost tier draws into an offscreen board at `scale` times the
+    // window size and redraws only the cells that changed since last frame
+    void setRenderQuality(RenderQuality value, float scale = 1.0f);
+    RenderQuality getRenderQuality() const { return quality; }
+    float getRenderScale() const { return renderScale; }
+    // Marbles in flight are drawn over the board in one instanced draw, and
+    // the cells they are heading for are left empty until they land
+    void setAnimator(Animator* value) { animator = value; }
+    void setBoardRenderMode(BoardRenderMode mode) { boardMode = mode; }
+    BoardRenderMode getBoardRenderMode() const { return boardMode; }
 
     // Helper functions
     glm::vec2 windowToBoard(int x, int y, const MarbleSolitaire& game);
@@ -33,19 +78,55 @@ private:
     int windowWidth, windowHeight;
 
     // OpenGL objects
-    GLuint squareVAO, squareVBO;
-    GLuint circleVAO, circleVBO;
-    GLuint highlightVAO, highlightVBO;
+    GLuint quadVAO, quadVBO;    // The unit quad, for the single-pass board and the wall
+    GLuint themeUBO;
+    // One stream per kind of quad, so no buffer is rewritten while a draw still reads it
+    InstanceBatch cellBatch, marbleBatch, selectionBatch, hintBatch, overlayBatch, animationBatch;
+    Animator* animator;         // Not owned; null draws every move at once
+    GLuint boardTexture;
+    int boardTextureSize;       // Side of the allocated texture, 0 before the first upload
+    int boardUniformSize;       // boardSize last given to boardShader
+    GLuint wallTexture;
+    int wallTextureRows;        // Rows of WALL_TEXTURE_WIDTH boards allocated so far
+
+    BoardRenderMode boardMode;
+    RenderQuality quality;
+    float renderScale;
+
+    // Low-cost tier: the board persists in its own framebuffer between frames
+    GLuint lowCostFBO, lowCostColor;
+    int lowCostWidth, lowCostHeight;
+    bool lowCostValid;          // False until the next frame redraws every cell
+    BoardLayout lowCostLayout;  // Separate from layout, so its texel diff stays its own
+    GLuint spriteTexture;
+    // The textured board carries the hint in its texels, but hints are found
+    // after the board is drawn: each one shows from the following frame
+    Move pendingHint;
+
+    // Per-frame instances for the board and marbles
+    BoardLayout layout;
 
     // Shaders
-    Shader squareShader;
-    Shader circleShader;
-    Shader highlightShader;
+    Shader quadShader;
+    Shader overlayShader;
+    Shader boardShader;
+    Shader wallShader;
+    Shader spriteShader;
+    Shader marbleShader;
 
     // Initialize geometry
-    void createSquare();
-    void createCircle();
-    void createHighlight();
+    void createQuad();
+    void createThemeBuffer();
+    // A vertex array over the unit quad with QuadInstance attributes per instance
+    void createInstanced(InstanceBatch& batch);
+    void createBoardTexture();
+    void createWallTexture();
+    void createMarbleSprite();
     // Rendering helpers
+    void renderBoardTexture(const MarbleSolitaire& game);
+    void renderLowCost(const MarbleSolitaire& game);
+    void renderAnimation(const MarbleSolitaire& game);
+    // Uploads the instances and draws them all in one call
+    void drawInstances(const Shader& shader, InstanceBatch& batch, const std::vector<QuadInstance>& instances);
 
 };
\ No newline at end of file
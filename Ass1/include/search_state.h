@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "bitboard.h"
+
+// Position as seen by the search engine: a plain value, cheap to copy and
+// store, kept apart from the interactive MarbleSolitaire session (which
+// also carries selection, history stacks and a timer)
+struct BoardState {
+    Bitboard pegs;
+    int8_t lastLanding;   // Hole the previous jump landed on, -1 if none
+    uint8_t pegCount;
+    uint16_t depth;       // Jumps played since the search started
+
+    static BoardState from(Bitboard pegs) {
+        BoardState state;
+        state.pegs = pegs;
+        state.lastLanding = -1;
+        state.pegCount = static_cast<uint8_t>(popCount(pegs));
+        state.depth = 0;
+        return state;
+    }
+
+    bool canPlay(const Jump& jump) const { return canJump(pegs, jump); }
+
+    BoardState played(const Jump& jump) const {
+        BoardState next = *this;
+        next.pegs = applyJump(pegs, jump);
+        next.lastLanding = static_cast<int8_t>(jump.to);
+        next.pegCount--;
+        next.depth++;
+        return next;
+    }
+};
+
+static_assert(sizeof(BoardState) <= 16, "BoardState must stay within 16 bytes");
+static_assert(std::is_trivially_copyable<BoardState>::value, "BoardState must be trivially copyable");
+
+// Bump-pointer allocator over one block reserved up front. reset() frees
+// everything at once, so a search allocates per node without touching the heap.
+class Arena {
+public:
+    explicit Arena(size_t bytes);
+    ~Arena();
+
+    // Returns nullptr when the arena is exhausted
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void reset() { used = 0; }
+    size_t getUsed() const { return used; }
+    size_t getPeak() const { return peak; }
+    size_t getCapacity() const { return capacity; }
+
+private:
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    char* memory;
+    size_t capacity;
+    size_t used;
+    size_t peak;
+};
+
+// Fixed-capacity stack living in an arena. Used as the flat move/undo stack
+// of a search: each ply pushes its moves on top and truncates them on return.
+template <typename T>
+class FlatStack {
+    static_assert(std::is_trivially_copyable<T>::value, "FlatStack holds plain values only");
+
+public:
+    FlatStack() : items(nullptr), count(0), capacity(0) {}
+
+    bool attach(Arena& arena, size_t size) {
+        items = arena.allocateArray<T>(size);
+        capacity = items ? size : 0;
+        count = 0;
+        return items != nullptr;
+    }
+
+    bool push(const T& item) {
+        if (count == capacity) return false;
+        items[count++] = item;
+        return true;
+    }
+
+    void pop() { count--; }
+    void truncate(size_t size) { count = size; }
+    void clear() { count = 0; }
+
+    T& top() { return items[count - 1]; }
+    T& operator[](size_t index) { return items[index]; }
+    const T& operator[](size_t index) const { return items[index]; }
+    T* begin() { return items; }
+    T* end() { return items + count; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == capacity; }
+
+private:
+    T* items;
+    size_t count;
+    size_t capacity;
+};
+
+// Number of global operator new calls so far, across all threads. Taking
+// the difference around a search proves it made no heap allocations.
+uint64_t heapAllocationCount();
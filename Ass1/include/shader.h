@@ -32,6 +32,10 @@ public:
     void setMat3(const std::string& name, const glm::mat3& mat) const;
     void setMat4(const std::string& name, const glm::mat4& mat) const;
 
+    // Points a uniform block of the program at a buffer binding; blocks the
+    // program does not use are left alone
+    void bindUniformBlock(const std::string& name, GLuint binding) const;
+
 private:
     // Utility function for checking shader compilation/linking errors
     void checkCompileErrors(GLuint shader, std::string type);
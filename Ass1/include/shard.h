@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+#include "solution_counter.h"
+
+// Splitting an exhaustive analysis into independent shards. Every jump
+// sequence of a fixed length from the start (an "opening prefix") gets a
+// stable index; shard i of n takes the prefixes with index % n == i, so
+// shards can run as separate processes or on separate machines.
+
+struct OpeningPrefix {
+    std::vector<int> jumps;   // Jump ids played from the start
+    Bitboard pegs;            // Position after those jumps
+};
+
+// Prefixes in a fixed order; games that end early stay as shorter prefixes
+std::vector<OpeningPrefix> openingPrefixes(const BoardShape& shape, Bitboard start, int depth);
+
+struct PrefixResult {
+    uint64_t index = 0;
+    bool solvable = false;
+    SolutionCount solutions = 0;   // Winning continuations after the prefix
+};
+
+struct ShardResult {
+    int shardIndex = 0;
+    int shardCount = 1;
+    int depth = 0;
+    Bitboard start = 0;
+    uint64_t prefixTotal = 0;            // Prefixes across all shards
+    std::vector<PrefixResult> prefixes;  // This shard's prefixes, in index order
+    uint64_t nodes = 0;
+    uint64_t memoEntries = 0;
+    double seconds = 0.0;
+};
+
+struct MergedResult {
+    SolutionCount solutions = 0;
+    uint64_t solvablePrefixes = 0;
+    std::vector<bool> solvable;          // One bit per prefix index
+    uint64_t nodes = 0;
+    double cpuSeconds = 0.0;             // Sum over shards
+    double wallSeconds = 0.0;            // Slowest shard
+};
+
+ShardResult runShard(const BoardShape& shape, Bitboard start, int depth, int shardIndex, int shardCount);
+
+// Plain-text shard files, written to a temporary name and renamed into place
+bool writeShardResult(const std::string& path, const ShardResult& result);
+bool readShardResult(const std::string& path, ShardResult& result);
+
+// Combines shard results independently of the order they finished in.
+// Fails if shards disagree on the analysis or any prefix is missing.
+bool mergeShardResults(const std::vector<ShardResult>& shards, MergedResult& merged, std::string& error);
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+#include "game_record.h"
+#include "mcts.h"
+#include "transposition_table.h"
+
+enum SimulationPolicy {
+    POLICY_RANDOM,          // Uniformly random legal jump
+    POLICY_GREEDY_MOBILITY, // Jump leaving the most follow-up jumps, ties broken at random
+    POLICY_EPSILON_SOLVER,  // Random with probability epsilon, otherwise a jump proven to keep the game winnable
+    POLICY_MCTS             // Monte Carlo tree search with a fixed number of rollouts per jump
+};
+
+bool parsePolicy(const std::string& name, SimulationPolicy& policy);
+const char* policyName(SimulationPolicy policy);
+
+struct SimulationConfig {
+    SimulationPolicy policy = POLICY_RANDOM;
+    uint64_t games = 1000000;
+    uint64_t seed = 1;
+    int threads = 0;              // 0 uses every hardware thread
+    double epsilon = 0.1;
+    size_t oracleMegabytes = 256; // Solvability cache, split evenly between epsilon-solver threads
+    uint64_t oracleNodes = 100000;// Proof effort per solver move before giving up on a jump
+    uint64_t mctsIterations = 2000;// Rollouts per tree search move
+};
+
+// Distributions over a batch of finished games
+struct SimulationStats {
+    uint64_t games = 0;
+    uint64_t wins = 0;                    // Games ending with a single marble
+    std::vector<uint64_t> finalPegs;      // Indexed by marbles left
+    std::vector<uint64_t> lengths;        // Indexed by jumps played
+    std::vector<uint64_t> holeEnds;       // Indexed by hole: games ending with a marble there
+    double seconds = 0.0;
+
+    void reset(const BoardShape& shape);
+    void merge(const SimulationStats& other);
+};
+
+// Headless batch self-play on the bitboard engine. Each thread plays its
+// share of the games with its own seeded stream and, for the epsilon
+// policy, its own solvability cache, so what a thread proves within its
+// node budget never depends on the others. A run is reproducible for a
+// given seed and thread count with every policy. Playing a game never
+// allocates.
+class Simulator {
+public:
+    explicit Simulator(const BoardShape& shape);
+
+    // With a recorder, every game is also appended to it
+    SimulationStats run(Bitboard start, const SimulationConfig& config, GameRecordWriter* recorder = nullptr);
+
+    static bool writeCsv(const std::string& path, const BoardShape& shape, const SimulationStats& stats);
+    static bool writeJson(const std::string& path, const BoardShape& shape, const SimulationConfig& config,
+                          const SimulationStats& stats);
+
+    // One move of a policy among the `count` legal jump ids. The random and
+    // greedy policies need neither `player`, `oracle` nor a running batch, so
+    // other self-play drivers (the spectator wall) call this directly.
+    int chooseJump(Bitboard pegs, const int* legal, int count, const SimulationConfig& config,
+                   std::mt19937_64& rng, bool& winnable, MctsPlayer* player, TranspositionTable* oracle);
+
+private:
+    void worker(int threadIndex, uint64_t games, Bitboard start, const SimulationConfig& config,
+                size_t oracleMegabytes, SimulationStats& stats, GameRecordWriter* recorder);
+    // 1 if a single marble can be reached, 0 if not, -1 if the budget ran out
+    // first. The oracle maps canonical positions to 1 solvable, 0 dead end.
+    int solvable(Bitboard pegs, uint64_t& budget, TranspositionTable& oracle);
+
+    const BoardShape& shape;
+};
@@ -0,0 +1,108 @@
+#ifndef SOLITAIRE_C_H
+#define SOLITAIRE_C_H
+
+/*
+ * C interface to the game engine, for use from other languages and tools.
+ *
+ * Boards are packed as in the C++ engine: bit (row * size + col) is set when
+ * that hole holds a marble. Every batch function works on arrays the caller
+ * owns, reads and writes them in place and allocates nothing, so a batch can
+ * live in shared memory, a NumPy array or a memory-mapped file.
+ *
+ * Functions return a count (>= 0) or a negative SOLITAIRE_ERROR_* code.
+ * Calls that only read the engine may run concurrently; the solvability
+ * calls may too, they share a lock-free cache.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define SOLITAIRE_API __declspec(dllexport)
+#else
+#define SOLITAIRE_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a signature or the meaning of an existing call changes */
+#define SOLITAIRE_API_VERSION 1
+
+/* Legal jumps of one board as a bit set over jump ids, this many words long */
+#define SOLITAIRE_JUMP_WORDS 2
+
+typedef uint64_t solitaire_board;
+typedef struct solitaire_engine solitaire_engine;
+
+enum {
+    SOLITAIRE_ENGLISH = 0,
+    SOLITAIRE_FRENCH = 1
+};
+
+enum {
+    SOLITAIRE_ERROR_ARGUMENT = -1,   /* Null engine or array, or an unknown board */
+    SOLITAIRE_ERROR_MEMORY = -2
+};
+
+/* Results of solitaire_solvable */
+enum {
+    SOLITAIRE_DEAD_END = 0,
+    SOLITAIRE_WINNABLE = 1,
+    SOLITAIRE_INVALID = 2            /* Marbles outside the board's holes */
+};
+
+SOLITAIRE_API int solitaire_api_version(void);
+
+/* table_megabytes sizes the solvability cache; NULL on failure */
+SOLITAIRE_API solitaire_engine* solitaire_engine_create(int board, size_t table_megabytes);
+SOLITAIRE_API void solitaire_engine_destroy(solitaire_engine* engine);
+
+/*
+ * Answers opening positions from a book written by `solitaire_tool book-build`
+ * instead of searching. Call before the engine is shared between threads.
+ * Fails with SOLITAIRE_ERROR_ARGUMENT for a missing file or another board.
+ */
+SOLITAIRE_API int solitaire_engine_load_book(solitaire_engine* engine, const char* path);
+
+/* Geometry. Jump ids are stable for a board and index every batch below. */
+SOLITAIRE_API int solitaire_board_size(const solitaire_engine* engine);
+SOLITAIRE_API solitaire_board solitaire_holes(const solitaire_engine* engine);
+SOLITAIRE_API solitaire_board solitaire_start(const solitaire_engine* engine);
+SOLITAIRE_API int solitaire_jump_count(const solitaire_engine* engine);
+SOLITAIRE_API int solitaire_jump(const solitaire_engine* engine, int jump, int* from, int* over, int* to);
+
+/*
+ * boards[i] = boards[i] after jumps[i]. A negative id skips that board, an
+ * illegal jump leaves it unchanged. applied (may be NULL) receives 1 or 0 per
+ * board. Returns the number of jumps made.
+ */
+SOLITAIRE_API int64_t solitaire_apply_jumps(const solitaire_engine* engine, solitaire_board* boards,
+                                            const int32_t* jumps, size_t count, uint8_t* applied);
+
+/*
+ * Legal jumps of every board: masks (may be NULL) receives
+ * SOLITAIRE_JUMP_WORDS words per board, bit j of the set being jump id j;
+ * counts (may be NULL) receives how many there are. Returns the number of
+ * boards with at least one jump.
+ */
+SOLITAIRE_API int64_t solitaire_legal_jumps(const solitaire_engine* engine, const solitaire_board* boards,
+                                            size_t count, uint64_t* masks, uint8_t* counts);
+
+/*
+ * results[i] is one of SOLITAIRE_DEAD_END, SOLITAIRE_WINNABLE or
+ * SOLITAIRE_INVALID. winning_jumps (may be NULL) receives a jump that keeps
+ * each board winnable, or -1. Returns the number of winnable boards.
+ */
+SOLITAIRE_API int64_t solitaire_solvable(solitaire_engine* engine, const solitaire_board* boards, size_t count,
+                                         uint8_t* results, int32_t* winning_jumps);
+
+/* Replaces every board with the representative of its symmetry class */
+SOLITAIRE_API int64_t solitaire_canonical(const solitaire_engine* engine, solitaire_board* boards, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
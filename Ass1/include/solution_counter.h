@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+
+// Solution counts outgrow 64 bits on larger boards
+typedef unsigned __int128 SolutionCount;
+
+class OpeningBook;
+
+std::string formatCount(SolutionCount value);
+bool parseCount(const std::string& text, SolutionCount& value);
+
+// Fixed-size open-addressing map from canonical position to its count,
+// shared by every counting thread. The table is split into independently
+// locked parts so threads rarely wait for each other.
+class CountMemo {
+public:
+    explicit CountMemo(size_t megabytes);
+
+    bool find(Bitboard key, SolutionCount& value) const;
+    bool insert(Bitboard key, SolutionCount value);   // false when that part of the table is full
+    void clear();
+
+    size_t size() const { return count.load(); }
+    size_t getCapacity() const { return entries.size(); }
+
+    // Binary memo files: "MSCM", version, board size and holes, then entries
+    bool save(const std::string& path, const BoardShape& shape) const;
+    bool load(const std::string& path, const BoardShape& shape);
+
+private:
+    static const size_t PARTS = 4096;
+
+    struct Entry {
+        Bitboard key;      // 0 marks an empty slot: no position is ever empty
+        uint64_t low;
+        uint64_t high;
+    };
+
+    size_t partOf(Bitboard key) const;
+
+    std::vector<Entry> entries;
+    size_t partSize;               // Slots per part, a power of two
+    std::unique_ptr<std::mutex[]> locks;
+    std::atomic<size_t> count;
+};
+
+// Counts the distinct jump sequences that take a position down to a single
+// marble. Results are memoized per canonical position, since symmetric
+// positions have the same number of winning continuations. Jumps follow the
+// same rules as MarbleSolitaire::makeMove. With an opening book that holds
+// counts, positions in it are answered from the book.
+class SolutionCounter {
+public:
+    explicit SolutionCounter(const BoardShape& shape, size_t memoMegabytes = 256);
+
+    SolutionCount count(Bitboard pegs);
+
+    // Splits the positions a few jumps in between threads sharing one memo
+    SolutionCount countParallel(Bitboard pegs, int threads, int splitDepth = 4);
+
+    // Not owned; must be for the same board shape, or null. Ignored without counts.
+    void setBook(const OpeningBook* openingBook);
+
+    bool saveMemo(const std::string& path) const { return memo.save(path, shape); }
+    bool loadMemo(const std::string& path) { return memo.load(path, shape); }
+
+    uint64_t getNodes() const { return nodes.load(); }
+    size_t getMemoSize() const { return memo.size(); }
+    size_t getMemoCapacity() const { return memo.getCapacity(); }
+    void clear() { memo.clear(); nodes = 0; }
+
+private:
+    SolutionCount countFrom(Bitboard pegs, uint64_t& expanded);
+
+    const BoardShape& shape;
+    CountMemo memo;
+    std::atomic<uint64_t> nodes;
+    std::atomic<bool> memoFull;
+    const OpeningBook* book;
+    int bookMinPegs;             // Fewest marbles a book position can have
+};
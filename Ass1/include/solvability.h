@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+
+#include "bitboard.h"
+#include "transposition_table.h"
+
+class OpeningBook;
+
+// Exact answer to "can this position still end with one marble?". Every
+// position proved either way goes into a lock-free table, so repeated and
+// neighbouring questions are nearly free. Any number of threads may ask at once.
+// With an opening book set, positions in it are answered without searching.
+class SolvabilityOracle {
+public:
+    SolvabilityOracle(const BoardShape& shape, size_t tableMegabytes = 64);
+
+    bool solvable(Bitboard pegs);
+
+    // A jump that keeps the position winnable, or -1 when there is none
+    int winningJump(Bitboard pegs);
+
+    // Ages what earlier questions cached, so it goes first when the table fills
+    void newSearch() { table.newSearch(); }
+
+    // Not owned; must be for the same board shape, or null
+    void setBook(const OpeningBook* openingBook) { book = openingBook; }
+
+    const BoardShape& getShape() const { return shape; }
+    const TranspositionTable& getTable() const { return table; }
+
+private:
+    BoardShape shape;
+    TranspositionTable table;   // Canonical position -> 1 solvable, 0 dead end
+    const OpeningBook* book;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bitboard.h"
+#include "simulator.h"
+
+enum WallBoardState {
+    WALL_PLAYING = 0,
+    WALL_WON = 1,       // Finished with a single marble, held up for a while
+    WALL_LOST = 2
+};
+
+// One board of a snapshot: 16 bytes, uploaded as one RGBA32UI texel
+// (pegs low, pegs high, jumps, state), exactly as wall.fs reads it
+struct WallBoard {
+    Bitboard pegs;
+    uint32_t jumps;     // Played so far in the current game
+    uint32_t state;     // WallBoardState
+};
+static_assert(sizeof(WallBoard) == 16, "wall boards are uploaded as raw 16-byte texels");
+
+struct WallConfig {
+    int boards = 1000;
+    int threads = 0;                      // 0 leaves one hardware thread to the renderer
+    SimulationPolicy policy = POLICY_RANDOM; // Random or greedy: cheap enough for every board
+    int tickMilliseconds = 100;           // Each board plays one jump per tick; 0 runs flat out
+    int holdTicks = 20;                   // Ticks a finished game stays up before it restarts
+    uint64_t seed = 1;
+};
+
+struct WallStats {
+    uint64_t ticks = 0;
+    uint64_t games = 0;    // Finished games
+    uint64_t wins = 0;
+};
+
+// Self-play on many boards at once, for watching batch play live. Worker
+// threads each own a slice of the boards and advance them in lockstep ticks,
+// writing into the back half of a double-buffered snapshot. The last thread
+// to finish a tick flips the buffers, so a reader always copies a complete
+// tick and never waits on the simulation for longer than that flip.
+class SpectatorWall {
+public:
+    SpectatorWall(const BoardShape& shape, Bitboard start, const WallConfig& config);
+    ~SpectatorWall();
+
+    void start();
+    void stop();
+
+    // Copies the newest tick into `out` when it is newer than `sequence`, and
+    // moves `sequence` on; false when nothing changed since the last call
+    bool latest(std::vector<WallBoard>& out, uint64_t& sequence) const;
+
+    WallStats getStats() const;
+    int getBoards() const { return config.boards; }
+    int getThreads() const { return static_cast<int>(workers.size()); }
+    const BoardShape& getShape() const { return shape; }
+
+private:
+    void worker(int index, int threads);
+    // Waits for every worker to finish the tick; the last one publishes it
+    bool finishTick(int threads);
+
+    const BoardShape& shape;
+    Bitboard startPegs;
+    WallConfig config;
+    SimulationConfig policy;
+    Simulator simulator;
+
+    std::vector<WallBoard> buffers[2];
+    int front;                       // Buffer readers copy; workers write the other
+    uint64_t published;              // Ticks published so far
+    mutable std::mutex publishMutex;
+
+    std::mutex tickMutex;
+    std::condition_variable tickDone;
+    int arrived;
+    uint64_t tick;
+    std::chrono::steady_clock::time_point epoch;
+
+    std::atomic<bool> running;
+    std::atomic<uint64_t> games;
+    std::atomic<uint64_t> wins;
+    std::vector<std::thread> workers;
+};
@@ -3,10 +3,34 @@
 
 #include <glm/glm.hpp>
 #include <string>
+#include <vector>
+
+// Binding point of the ThemeBlock uniform buffer shared by every shader program
+const unsigned int THEME_BLOCK_BINDING = 0;
+
+// The ThemeBlock of the shaders, std140: every member is a vec4 or a mat4, so
+// the C++ layout matches member for member without padding
+struct ThemeUniforms {
+    glm::mat4 projection;
+    glm::vec4 backgroundColor;
+    glm::vec4 boardColor;
+    glm::vec4 marbleColor;
+    glm::vec4 selectionColor;
+    glm::vec4 hintColor;
+    glm::vec4 winnableColor;
+    glm::vec4 deadColor;
+    glm::vec4 pendingColor;
+    glm::vec4 placement;        // Board origin x, origin y, width, unused
+    glm::vec4 scales;           // Cell, marble, overlay, marble depth
+};
+static_assert(sizeof(ThemeUniforms) == 224, "ThemeUniforms must match the std140 ThemeBlock");
 
 // Theme class to store all visual styling parameters
 class Theme {
 public:
+    std::string NAME = "Default";
+    std::string DESCRIPTION;
+
     // Board layout constants
     float BOARD_WIDTH = 1.6f;
     float BOARD_ORIGIN_X = -0.8f;
@@ -24,9 +48,40 @@ public:
     glm::vec4 HIGHLIGHT_COLOR = glm::vec4(1.0f, 1.0f, 0.0f, 0.5f);
     glm::vec4 TEXT_COLOR = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
 
+    // Move quality overlay: rings around cells, strongest for the most winning lines
+    glm::vec4 WINNABLE_COLOR = glm::vec4(0.2f, 0.9f, 0.3f, 0.85f);
+    glm::vec4 DEAD_COLOR = glm::vec4(0.95f, 0.2f, 0.15f, 0.75f);
+    glm::vec4 PENDING_COLOR = glm::vec4(0.85f, 0.85f, 0.85f, 0.35f);
+    float OVERLAY_SCALE_FACTOR = 0.95f;
+
+    // The selection keeps the highlight colour but is never fainter than 0.4
+    glm::vec4 selectionColor() const {
+        glm::vec4 color = HIGHLIGHT_COLOR;
+        if (color.a < 0.4f) color.a = 0.4f;
+        return color;
+    }
+
+    // Fainter than the selection, so a hint never looks like a choice the player made
+    glm::vec4 hintColor() const {
+        glm::vec4 color = HIGHLIGHT_COLOR;
+        color.a = 0.25f;
+        return color;
+    }
+
+    ThemeUniforms uniforms() const;
+
+    // A theme file holds `key = value` lines, values being numbers separated
+    // by spaces, or text for `name` and `description`; `#` starts a comment.
+    // Keys left out keep their default. On failure `error` says which line.
+    static bool loadFromFile(const std::string& path, Theme& theme, std::string& error);
+    // Every *.theme file in a directory, sorted by file name; unreadable files are skipped
+    static std::vector<Theme> loadDirectory(const std::string& directory);
+
     // Preset themes
     static Theme classicWood() {
         Theme theme;
+        theme.NAME = "Classic Wood";
+        theme.DESCRIPTION = "Wood board with blue marbles";
         theme.BACKGROUND_COLOR = glm::vec4(0.12f, 0.08f, 0.05f, 1.0f);  // Dark wood
         theme.BOARD_COLOR = glm::vec4(0.76f, 0.6f, 0.42f, 1.0f);       // Light wood
         theme.MARBLE_COLOR = glm::vec4(0.2f, 0.5f, 0.9f, 1.0f);        // Blue glass
@@ -36,6 +91,8 @@ public:
 
     static Theme modern() {
         Theme theme;
+        theme.NAME = "Modern";
+        theme.DESCRIPTION = "Gray board with teal marbles";
         theme.BACKGROUND_COLOR = glm::vec4(0.12f, 0.15f, 0.18f, 1.0f); // Dark slate
         theme.BOARD_COLOR = glm::vec4(0.25f, 0.28f, 0.3f, 1.0f);       // Soft gray
         theme.MARBLE_COLOR = glm::vec4(0.18f, 0.8f, 0.7f, 1.0f);       // Teal
@@ -45,6 +102,8 @@ public:
 
     static Theme royal() {
         Theme theme;
+        theme.NAME = "Royal";
+        theme.DESCRIPTION = "Purple board with gold marbles";
         theme.BACKGROUND_COLOR = glm::vec4(0.05f, 0.1f, 0.2f, 1.0f);   // Navy
         theme.BOARD_COLOR = glm::vec4(0.25f, 0.18f, 0.35f, 1.0f);      // Purple
         theme.MARBLE_COLOR = glm::vec4(0.9f, 0.75f, 0.1f, 1.0f);       // Gold
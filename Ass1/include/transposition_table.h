@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "bitboard.h"
+
+// Sizes accepted from the command line; the constructor itself takes any size
+const size_t TABLE_MIN_MEGABYTES = 64;
+const size_t TABLE_MAX_MEGABYTES = size_t(16) << 10;
+
+enum ReplacementPolicy {
+    REPLACE_ALWAYS,          // A new position always takes a slot, chosen by its hash
+    REPLACE_DEPTH_PREFERRED  // Keep the deepest entries, stale searches go first
+};
+
+struct TranspositionStats {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t stores = 0;
+    uint64_t collisions = 0;   // Stores that evicted a different position
+    uint64_t occupied = 0;     // Slots holding an entry
+    uint64_t capacity = 0;
+
+    double hitRate() const { return probes ? double(hits) / probes : 0.0; }
+    double occupancy() const { return capacity ? double(occupied) / capacity : 0.0; }
+};
+
+// Fixed-size, lock-free position cache keyed by (canonical) packed board.
+// Slots are grouped in 64-byte buckets, one cache line each. Every slot
+// stores key ^ data next to data, so a slot torn by two threads writing at
+// once fails validation and reads as a miss instead of a wrong value.
+// Any number of threads may probe and store concurrently.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes = 64, ReplacementPolicy policy = REPLACE_DEPTH_PREFERRED,
+                                bool hugePages = false);
+    ~TranspositionTable();
+
+    // A hit from an earlier search is brought into the current one
+    bool probe(Bitboard key, int& value);
+    void store(Bitboard key, int value, int depth = 0);
+    void clear();
+
+    // Marks existing entries as stale without clearing them, so they are the
+    // first to be replaced. Call it when a new search or query starts; safe
+    // while other threads probe and store.
+    void newSearch() { generation.fetch_add(1, std::memory_order_relaxed); }
+
+    void setPolicy(ReplacementPolicy value) { policy = value; }
+    size_t getCapacity() const { return bucketCount * SLOTS_PER_BUCKET; }
+    size_t getBytes() const { return bucketCount * sizeof(Bucket); }
+    bool usesHugePages() const { return hugePagesActive; }
+    TranspositionStats getStats() const;
+
+private:
+    static const int SLOTS_PER_BUCKET = 4;
+
+    struct Slot {
+        std::atomic<uint64_t> check;  // key ^ data
+        std::atomic<uint64_t> data;   // value | depth << 32 | generation << 48
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[SLOTS_PER_BUCKET];
+    };
+
+    static uint64_t pack(int value, int depth, int generation);
+    Bucket& bucketFor(Bitboard key) const;
+
+    TranspositionTable(const TranspositionTable&);
+    TranspositionTable& operator=(const TranspositionTable&);
+
+    Bucket* buckets;
+    size_t bucketCount;
+    int shift;
+    ReplacementPolicy policy;
+    bool hugePagesActive;
+    std::atomic<int> generation;   // Only the low 8 bits are stored
+
+    // Relaxed counters: exact enough for statistics, cheap to update
+    std::atomic<uint64_t> probes;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> stores;
+    std::atomic<uint64_t> collisions;
+};
@@ -0,0 +1,139 @@
+#include "animator.h"
+#include <algorithm>
+#include <cmath>
+
+Animator::Animator() : now(0.0), accumulator(0.0) {
+}
+
+void Animator::clear() {
+    tweens.clear();
+    hidden.clear();
+    instances.clear();
+    accumulator = 0.0;
+}
+
+void Animator::consume(MarbleSolitaire& game) {
+    game.takeMoveEvents(events);
+    for (const MoveEvent& event : events) {
+        if (event.kind == BOARD_RESET) {
+            clear();
+            continue;
+        }
+        interrupt(event.move);
+
+        const Move& move = event.move;
+        bool undo = event.kind == MOVE_UNDONE;
+        Position from = undo ? move.to : move.from;
+        Position to = undo ? move.from : move.to;
+
+        // The captured marble goes first, so the jumping one is drawn over it
+        Tween capture;
+        capture.fromRow = capture.toRow = static_cast<float>(move.jumped.row);
+        capture.fromCol = capture.toCol = static_cast<float>(move.jumped.col);
+        capture.fromScale = undo ? 0.3f : 1.0f;
+        capture.toScale = undo ? 1.0f : 0.3f;
+        capture.fromAlpha = undo ? 0.0f : 1.0f;
+        capture.toAlpha = undo ? 1.0f : 0.0f;
+        capture.arc = 0.0f;
+        capture.duration = CAPTURE_SECONDS;
+        // Played, the board has already emptied the cell; undone, it refilled it
+        capture.hiddenRow = undo ? move.jumped.row : -1;
+        capture.hiddenCol = undo ? move.jumped.col : -1;
+        add(capture);
+
+        Tween jump;
+        jump.fromRow = static_cast<float>(from.row);
+        jump.fromCol = static_cast<float>(from.col);
+        jump.toRow = static_cast<float>(to.row);
+        jump.toCol = static_cast<float>(to.col);
+        jump.fromScale = jump.toScale = 1.0f;
+        jump.fromAlpha = jump.toAlpha = 1.0f;
+        jump.arc = 0.25f;
+        jump.duration = JUMP_SECONDS;
+        jump.hiddenRow = to.row;
+        jump.hiddenCol = to.col;
+        add(jump);
+    }
+    events.clear();
+}
+
+void Animator::add(const Tween& tween) {
+    tweens.push_back(tween);
+    Tween& added = tweens.back();
+    added.start = static_cast<float>(now);
+    if (added.hiddenRow >= 0) {
+        hidden.push_back(Position(added.hiddenRow, added.hiddenCol));
+    }
+}
+
+void Animator::interrupt(const Move& move) {
+    size_t kept = 0;
+    for (size_t i = 0; i < tweens.size(); i++) {
+        Position end(static_cast<int>(tweens[i].toRow), static_cast<int>(tweens[i].toCol));
+        if (end == move.from || end == move.jumped || end == move.to) continue;
+        tweens[kept++] = tweens[i];
+    }
+    if (kept != tweens.size()) {
+        tweens.resize(kept);
+        step();
+    }
+}
+
+void Animator::advance(double frameSeconds) {
+    if (tweens.empty()) {
+        // Idle: restart the clock, so tween start times stay small enough for floats
+        now = 0.0;
+        accumulator = 0.0;
+        return;
+    }
+
+    accumulator += std::min(frameSeconds, ANIMATION_MAX_FRAME_SECONDS);
+    while (accumulator >= ANIMATION_STEP_SECONDS) {
+        accumulator -= ANIMATION_STEP_SECONDS;
+        now += ANIMATION_STEP_SECONDS;
+        step();
+    }
+}
+
+void Animator::step() {
+    // Finished tweens are compacted away and the hidden cells rebuilt in the same pass
+    hidden.clear();
+    size_t kept = 0;
+    for (size_t i = 0; i < tweens.size(); i++) {
+        const Tween& tween = tweens[i];
+        if (now >= tween.start + tween.duration) continue;
+        if (tween.hiddenRow >= 0) {
+            hidden.push_back(Position(tween.hiddenRow, tween.hiddenCol));
+        }
+        tweens[kept++] = tween;
+    }
+    tweens.resize(kept);
+}
+
+void Animator::buildInstances(const MarbleSolitaire& game, const Theme& theme) {
+    instances.clear();
+    if (tweens.empty()) return;
+
+    // Sampled between the last step and the next, not at the last step
+    float time = static_cast<float>(now + accumulator);
+    float cellSize = theme.BOARD_WIDTH / game.getBoardSize();
+    float marbleSize = cellSize * theme.MARBLE_SCALE_FACTOR;
+    glm::vec2 origin = BoardLayout::cellCenter(game, theme, 0, 0);
+
+    for (const Tween& tween : tweens) {
+        float t = std::max(0.0f, std::min(1.0f, (time - tween.start) / tween.duration));
+        float eased = t * t * (3.0f - 2.0f * t);
+        float row = tween.fromRow + (tween.toRow - tween.fromRow) * eased;
+        float col = tween.fromCol + (tween.toCol - tween.fromCol) * eased;
+        float scale = tween.fromScale + (tween.toScale - tween.fromScale) * eased;
+        scale += tween.arc * std::sin(3.14159265f * t);
+
+        QuadInstance marble;
+        marble.center = glm::vec2(origin.x + cellSize * col, origin.y - cellSize * row);
+        marble.size = marbleSize * scale;
+        marble.depth = theme.MARBLE_Z_POSITION;
+        marble.color = theme.MARBLE_COLOR;
+        marble.color.a *= tween.fromAlpha + (tween.toAlpha - tween.fromAlpha) * eased;
+        instances.push_back(marble);
+    }
+}
@@ -0,0 +1,142 @@
+#include "anytime_solver.h"
+#include <algorithm>
+#include <chrono>
+
+AnytimeSolver::AnytimeSolver(const BoardShape& boardShape, MoveOrderer* moveOrderer, size_t tableMegabytes)
+    : shape(boardShape), orderer(moveOrderer), table(tableMegabytes), startPegs(0),
+      goalMask(boardShape.getHoles()), symmetryMask(BoardShape::ALL_SYMMETRIES), status(ANYTIME_IDLE),
+      nodes(0), bestPegs(0),
+      arena((boardShape.getHoleCount() + 1) *
+            (sizeof(Frame) + (boardShape.getJumps().size() + 1) * sizeof(int)) + 4096) {
+    bestLine.reserve(boardShape.getHoleCount());
+}
+
+void AnytimeSolver::start(Bitboard pegs, int goalHole) {
+    goalMask = goalHole < 0 ? shape.getHoles() : (Bitboard(1) << goalHole);
+    symmetryMask = shape.stabilizer(goalMask);
+    startPegs = pegs;
+    nodes = 0;
+    table.clear();
+    if (orderer) {
+        orderer->reset();
+    }
+
+    arena.reset();
+    frames.attach(arena, shape.getHoleCount() + 1);
+    jumps.attach(arena, (shape.getHoleCount() + 1) * shape.getJumps().size());
+    line.attach(arena, shape.getHoleCount());
+
+    bestLine.clear();
+    BoardState root = BoardState::from(pegs);
+    bestPegs = root.pegCount;
+    status = ANYTIME_RUNNING;
+    if (root.pegCount <= 1) {
+        status = (pegs & goalMask) ? ANYTIME_SOLVED : ANYTIME_EXHAUSTED;
+        return;
+    }
+    push(root, shape.canonical(pegs, symmetryMask));
+}
+
+void AnytimeSolver::push(const BoardState& state, Bitboard key) {
+    Frame frame;
+    frame.state = state;
+    frame.key = key;
+    frame.firstJump = static_cast<uint32_t>(jumps.size());
+    frame.fewestPegs = state.pegCount;
+
+    Bitboard movers = state.pegs;
+    while (movers) {
+        int hole = lowestBit(movers);
+        movers &= movers - 1;
+        for (int id : shape.jumpsFrom(hole)) {
+            if (state.canPlay(shape.getJumps()[id])) {
+                jumps.push(id);
+            }
+        }
+    }
+    frame.endJump = static_cast<uint32_t>(jumps.size());
+    frame.nextJump = frame.firstJump;
+    if (orderer) {
+        orderer->order(state, jumps.begin() + frame.firstJump, static_cast<int>(frame.endJump - frame.firstJump));
+    }
+    frames.push(frame);
+}
+
+void AnytimeSolver::leaf(const BoardState& state, int fewestPegs) {
+    // The line on the stack leads to `state`; keep it if it got further
+    if (state.pegCount < bestPegs) {
+        bestPegs = state.pegCount;
+        bestLine.assign(line.begin(), line.end());
+    }
+
+    Frame& parent = frames.top();
+    parent.fewestPegs = std::min(parent.fewestPegs, fewestPegs);
+    if (orderer) {
+        orderer->searched(parent.state.depth, line.top(), fewestPegs);
+    }
+    line.pop();
+}
+
+AnytimeStatus AnytimeSolver::step(uint64_t maxNodes, int maxMicroseconds) {
+    if (status != ANYTIME_RUNNING) {
+        return status;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(maxMicroseconds);
+    uint64_t nodeLimit = nodes + maxNodes;
+
+    while (!frames.empty()) {
+        if (maxNodes && nodes >= nodeLimit) break;
+        // Reading the clock costs more than a node, so only look now and then
+        if (maxMicroseconds && (nodes & 63) == 0 && std::chrono::steady_clock::now() >= deadline) break;
+
+        Frame& frame = frames.top();
+        if (frame.nextJump == frame.endJump) {
+            // Every jump tried: a dead end, so report back to the parent
+            table.store(frame.key, frame.fewestPegs, frame.state.pegCount);
+            BoardState state = frame.state;
+            int fewestPegs = frame.fewestPegs;
+            jumps.truncate(frame.firstJump);
+            frames.pop();
+            if (frames.empty()) {
+                status = ANYTIME_EXHAUSTED;
+                break;
+            }
+            leaf(state, fewestPegs);
+            continue;
+        }
+
+        int id = jumps[frame.nextJump++];
+        BoardState child = frame.state.played(shape.getJumps()[id]);
+        line.push(id);
+        nodes++;
+
+        if (child.pegCount == 1) {
+            if (child.pegs & goalMask) {
+                bestPegs = 1;
+                bestLine.assign(line.begin(), line.end());
+                status = ANYTIME_SOLVED;
+                break;
+            }
+            leaf(child, 1);
+            continue;
+        }
+
+        Bitboard key = shape.canonical(child.pegs, symmetryMask);
+        int fewestPegs;
+        if (table.probe(key, fewestPegs)) {
+            leaf(child, fewestPegs);
+            continue;
+        }
+        push(child, key);
+    }
+    return status;
+}
+
+bool AnytimeSolver::getHint(Move& move) const {
+    if (bestLine.empty()) {
+        return false;
+    }
+    move = shape.toMove(bestLine.front());
+    return true;
+}
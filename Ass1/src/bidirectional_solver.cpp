@@ -0,0 +1,129 @@
+#include "bidirectional_solver.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+BidirectionalSolver::BidirectionalSolver(const BoardShape& boardShape)
+    : shape(boardShape), symmetryMask(BoardShape::ALL_SYMMETRIES) {
+}
+
+void BidirectionalSolver::expand(const Layer& from, Layer& to, bool forward) const {
+    const std::vector<Jump>& jumps = shape.getJumps();
+    to.clear();
+    for (Bitboard pegs : from) {
+        for (const Jump& jump : jumps) {
+            bool legal = forward ? canJump(pegs, jump) : canUnjump(pegs, jump);
+            if (legal) {
+                to.push_back(shape.canonical(applyJump(pegs, jump), symmetryMask));
+            }
+        }
+    }
+    std::sort(to.begin(), to.end());
+    to.erase(std::unique(to.begin(), to.end()), to.end());
+    to.shrink_to_fit();
+}
+
+bool BidirectionalSolver::contains(const Layer& layer, Bitboard pegs) const {
+    return std::binary_search(layer.begin(), layer.end(), shape.canonical(pegs, symmetryMask));
+}
+
+BidirectionalResult BidirectionalSolver::solve(Bitboard start, Bitboard goal, int meetPegs) {
+    BidirectionalResult result;
+    auto startTime = std::chrono::steady_clock::now();
+
+    int startPegs = popCount(start);
+    int goalPegs = popCount(goal);
+    if (startPegs < goalPegs || goalPegs == 0 ||
+        shape.positionClass(start) != shape.positionClass(goal)) {
+        return result;
+    }
+
+    // Merging symmetric positions is only safe under symmetries that fix
+    // both ends; then a canonical match is always the real start or goal
+    symmetryMask = shape.stabilizer(start) & shape.stabilizer(goal);
+
+    forwardLayers.assign(startPegs + 1, Layer());
+    backwardLayers.assign(startPegs + 1, Layer());
+    forwardLayers[startPegs].push_back(shape.canonical(start, symmetryMask));
+    backwardLayers[goalPegs].push_back(shape.canonical(goal, symmetryMask));
+
+    int forwardPegs = startPegs;
+    int backwardPegs = goalPegs;
+    bool exhausted = false;
+    while (forwardPegs > backwardPegs && !exhausted) {
+        bool stepForward;
+        if (meetPegs >= 0) {
+            stepForward = forwardPegs > std::max(meetPegs, goalPegs);
+        } else {
+            stepForward = forwardLayers[forwardPegs].size() <= backwardLayers[backwardPegs].size();
+        }
+
+        if (stepForward) {
+            expand(forwardLayers[forwardPegs], forwardLayers[forwardPegs - 1], true);
+            forwardPegs--;
+            exhausted = forwardLayers[forwardPegs].empty();
+        } else {
+            expand(backwardLayers[backwardPegs], backwardLayers[backwardPegs + 1], false);
+            backwardPegs++;
+            exhausted = backwardLayers[backwardPegs].empty();
+        }
+    }
+
+    for (int pegs = 0; pegs <= startPegs; pegs++) {
+        result.forwardStates += forwardLayers[pegs].size();
+        result.backwardStates += backwardLayers[pegs].size();
+    }
+
+    if (!exhausted) {
+        const Layer& forward = forwardLayers[forwardPegs];
+        const Layer& backward = backwardLayers[forwardPegs];
+        std::vector<Bitboard> common;
+        std::set_intersection(forward.begin(), forward.end(), backward.begin(), backward.end(),
+                              std::back_inserter(common));
+
+        if (!common.empty()) {
+            std::vector<Bitboard> boards = tracePath(common.front(), startPegs, goalPegs, forwardPegs);
+            for (size_t i = 0; i + 1 < boards.size(); i++) {
+                result.line.push_back(shape.toMove(shape.jumpBetween(boards[i], boards[i + 1])));
+            }
+            result.solved = true;
+            result.meetPegs = forwardPegs;
+        }
+    }
+
+    forwardLayers.clear();
+    backwardLayers.clear();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+std::vector<Bitboard> BidirectionalSolver::tracePath(Bitboard meet, int startPegs, int goalPegs, int meetPegs) const {
+    const std::vector<Jump>& jumps = shape.getJumps();
+
+    // Walk back to the start: every layer holds a predecessor of the current board
+    std::vector<Bitboard> boards(1, meet);
+    Bitboard current = meet;
+    for (int pegs = meetPegs + 1; pegs <= startPegs; pegs++) {
+        for (const Jump& jump : jumps) {
+            if (canUnjump(current, jump) && contains(forwardLayers[pegs], applyJump(current, jump))) {
+                current = applyJump(current, jump);
+                break;
+            }
+        }
+        boards.push_back(current);
+    }
+    std::reverse(boards.begin(), boards.end());
+
+    // Then forward to the goal through the backward layers
+    current = meet;
+    for (int pegs = meetPegs - 1; pegs >= goalPegs; pegs--) {
+        for (const Jump& jump : jumps) {
+            if (canJump(current, jump) && contains(backwardLayers[pegs], applyJump(current, jump))) {
+                current = applyJump(current, jump);
+                break;
+            }
+        }
+        boards.push_back(current);
+    }
+    return boards;
+}
@@ -0,0 +1,254 @@
+#include "bitboard.h"
+#include <algorithm>
+
+BoardShape::BoardShape(const std::string& shapeName, int boardSize, Bitboard holeMask)
+    : name(shapeName), size(boardSize), holes(holeMask), corners(0), validSymmetries(0) {
+    buildJumps();
+    buildSymmetries();
+}
+
+BoardShape BoardShape::cross(int size) {
+    // Mirrors MarbleSolitaire::initializeBoard(): a three-wide cross
+    int midPoint = size / 2;
+    Bitboard holes = 0;
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            bool inColumn = col >= midPoint - 1 && col <= midPoint + 1;
+            bool inRow = row >= midPoint - 1 && row <= midPoint + 1;
+            if (inColumn || inRow) {
+                holes |= Bitboard(1) << (row * size + col);
+            }
+        }
+    }
+    return BoardShape(size == 7 ? "english" : "cross" + std::to_string(size), size, holes);
+}
+
+BoardShape BoardShape::english() {
+    return cross(7);
+}
+
+BoardShape BoardShape::french() {
+    // English cross plus the four inner corner holes
+    BoardShape base = cross(7);
+    Bitboard holes = base.getHoles();
+    const int extra[4][2] = {{1, 1}, {1, 5}, {5, 1}, {5, 5}};
+    for (int i = 0; i < 4; i++) {
+        holes |= Bitboard(1) << (extra[i][0] * 7 + extra[i][1]);
+    }
+    return BoardShape("french", 7, holes);
+}
+
+bool BoardShape::isHole(int row, int col) const {
+    if (row < 0 || row >= size || col < 0 || col >= size) {
+        return false;
+    }
+    return (holes >> index(row, col)) & 1;
+}
+
+void BoardShape::buildJumps() {
+    jumps.clear();
+    jumpsByFrom.assign(size * size, std::vector<int>());
+
+    // Same direction order MarbleSolitaire uses: up, down, left, right
+    const int dr[] = {-1, 1, 0, 0};
+    const int dc[] = {0, 0, -1, 1};
+
+    Bitboard jumpedOver = 0;
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            if (!isHole(row, col)) continue;
+
+            for (int dir = 0; dir < 4; dir++) {
+                int overRow = row + dr[dir], overCol = col + dc[dir];
+                int toRow = row + 2 * dr[dir], toCol = col + 2 * dc[dir];
+                if (!isHole(overRow, overCol) || !isHole(toRow, toCol)) continue;
+
+                Jump jump;
+                jump.from = index(row, col);
+                jump.over = index(overRow, overCol);
+                jump.to = index(toRow, toCol);
+                jump.fromOver = (Bitboard(1) << jump.from) | (Bitboard(1) << jump.over);
+                jump.toMask = Bitboard(1) << jump.to;
+                jump.mask = jump.fromOver | jump.toMask;
+
+                jumpsByFrom[jump.from].push_back(static_cast<int>(jumps.size()));
+                jumps.push_back(jump);
+                jumpedOver |= Bitboard(1) << jump.over;
+            }
+        }
+    }
+
+    corners = holes & ~jumpedOver;
+
+    for (int i = 0; i < 3; i++) {
+        diagonals[0][i] = diagonals[1][i] = 0;
+    }
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            if (!isHole(row, col)) continue;
+            diagonals[0][(row + col) % 3] |= Bitboard(1) << index(row, col);
+            diagonals[1][(row - col + 3 * size) % 3] |= Bitboard(1) << index(row, col);
+        }
+    }
+}
+
+int BoardShape::findJump(int from, int to) const {
+    if (from < 0 || from >= size * size) return -1;
+    for (int id : jumpsByFrom[from]) {
+        if (jumps[id].to == to) return id;
+    }
+    return -1;
+}
+
+void BoardShape::legalJumps(Bitboard pegs, std::vector<int>& out) const {
+    out.clear();
+    for (size_t id = 0; id < jumps.size(); id++) {
+        if (canJump(pegs, jumps[id])) out.push_back(static_cast<int>(id));
+    }
+}
+
+void BoardShape::legalUnjumps(Bitboard pegs, std::vector<int>& out) const {
+    out.clear();
+    for (size_t id = 0; id < jumps.size(); id++) {
+        if (canUnjump(pegs, jumps[id])) out.push_back(static_cast<int>(id));
+    }
+}
+
+int BoardShape::jumpBetween(Bitboard before, Bitboard after) const {
+    // The changed holes identify the jump; the destination is the new marble
+    Bitboard changed = before ^ after;
+    if (popCount(changed) != 3 || popCount(after & changed) != 1) return -1;
+    for (size_t id = 0; id < jumps.size(); id++) {
+        if (jumps[id].mask == changed && (after & jumps[id].toMask)) {
+            return static_cast<int>(id);
+        }
+    }
+    return -1;
+}
+
+Move BoardShape::toMove(int jumpId) const {
+    const Jump& jump = jumps[jumpId];
+    return Move(position(jump.from), position(jump.to), position(jump.over));
+}
+
+Bitboard BoardShape::startPosition() const {
+    return holes & ~(Bitboard(1) << getCenter());
+}
+
+Bitboard BoardShape::fromGame(const MarbleSolitaire& game) const {
+    Bitboard pegs = 0;
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            if (game.getCell(row, col) == MARBLE) {
+                pegs |= Bitboard(1) << index(row, col);
+            }
+        }
+    }
+    return pegs;
+}
+
+void BoardShape::buildSymmetries() {
+    const int cells = size * size;
+    holeMap.assign(MAX_SYMMETRIES * 64, -1);
+    byteTables.assign(MAX_SYMMETRIES * 8 * 256, 0);
+    validSymmetries = 0;
+
+    for (int sym = 0; sym < MAX_SYMMETRIES; sym++) {
+        // The eight symmetries of the square: rotations, then reflections
+        for (int row = 0; row < size; row++) {
+            for (int col = 0; col < size; col++) {
+                int n = size - 1;
+                int r = row, c = col;
+                switch (sym) {
+                    case 0: r = row;     c = col;     break;
+                    case 1: r = col;     c = n - row; break;
+                    case 2: r = n - row; c = n - col; break;
+                    case 3: r = n - col; c = row;     break;
+                    case 4: r = row;     c = n - col; break;
+                    case 5: r = n - row; c = col;     break;
+                    case 6: r = col;     c = row;     break;
+                    case 7: r = n - col; c = n - row; break;
+                }
+                holeMap[sym * 64 + index(row, col)] = index(r, c);
+            }
+        }
+
+        for (int byte = 0; byte < 8; byte++) {
+            for (int value = 0; value < 256; value++) {
+                Bitboard mapped = 0;
+                for (int bit = 0; bit < 8; bit++) {
+                    int cell = byte * 8 + bit;
+                    if ((value >> bit) & 1 && cell < cells) {
+                        mapped |= Bitboard(1) << holeMap[sym * 64 + cell];
+                    }
+                }
+                byteTables[(sym * 8 + byte) * 256 + value] = mapped;
+            }
+        }
+
+        if (transform(holes, sym) == holes) {
+            validSymmetries |= 1 << sym;
+        }
+    }
+}
+
+Bitboard BoardShape::transform(Bitboard pegs, int sym) const {
+    const Bitboard* table = &byteTables[sym * 8 * 256];
+    Bitboard result = 0;
+    for (int byte = 0; byte < 8 && pegs; byte++, pegs >>= 8) {
+        result |= table[byte * 256 + (pegs & 0xFF)];
+    }
+    return result;
+}
+
+int BoardShape::transformHole(int hole, int sym) const {
+    return holeMap[sym * 64 + hole];
+}
+
+int BoardShape::stabilizer(Bitboard pattern) const {
+    int mask = 0;
+    for (int sym = 0; sym < MAX_SYMMETRIES; sym++) {
+        if ((validSymmetries >> sym) & 1 && transform(pattern, sym) == pattern) {
+            mask |= 1 << sym;
+        }
+    }
+    return mask;
+}
+
+Bitboard BoardShape::canonical(Bitboard pegs, int symmetryMask) const {
+    Bitboard best = pegs;
+    int allowed = symmetryMask & validSymmetries & ~1;
+    for (int sym = 1; sym < MAX_SYMMETRIES; sym++) {
+        if ((allowed >> sym) & 1) {
+            best = std::min(best, transform(pegs, sym));
+        }
+    }
+    return best;
+}
+
+int BoardShape::positionClass(Bitboard pegs) const {
+    // A straight jump touches one hole of each diagonal class, flipping the
+    // parity of all three counts, so the pairwise sums keep their parity
+    int result = 0;
+    for (int d = 0; d < 2; d++) {
+        int c0 = popCount(pegs & diagonals[d][0]);
+        int c1 = popCount(pegs & diagonals[d][1]);
+        int c2 = popCount(pegs & diagonals[d][2]);
+        result = (result << 2) | (((c0 + c1) & 1) << 1) | ((c1 + c2) & 1);
+    }
+    return result;
+}
+
+std::string BoardShape::toString(Bitboard pegs) const {
+    // Same notation as MarbleSolitaire::printBoard()
+    std::string out;
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            if (!isHole(row, col)) out += "X ";
+            else if ((pegs >> index(row, col)) & 1) out += "O ";
+            else out += ". ";
+        }
+        out += "\n";
+    }
+    return out;
+}
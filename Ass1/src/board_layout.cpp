@@ -0,0 +1,197 @@
+#include "board_layout.h"
+#include <algorithm>
+#include <cmath>
+
+BoardLayout::BoardLayout() : texelSize(0) {
+}
+
+glm::vec2 BoardLayout::cellCenter(const MarbleSolitaire& game, const Theme& theme, int row, int col) {
+    float cellSize = theme.BOARD_WIDTH / game.getBoardSize();
+    return glm::vec2(theme.BOARD_ORIGIN_X + cellSize * col + cellSize * 0.5f,
+                     theme.BOARD_ORIGIN_Y - cellSize * row - cellSize * 0.5f);
+}
+
+bool BoardLayout::isHidden(int row, int col) const {
+    for (const Position& cell : hiddenCells) {
+        if (cell.row == row && cell.col == col) return true;
+    }
+    return false;
+}
+
+void BoardLayout::buildCells(const MarbleSolitaire& game, const Theme& theme, const TexelRect* region) {
+    cells.clear();
+    float cellSize = theme.BOARD_WIDTH / game.getBoardSize();
+    TexelRect all;
+    all.width = all.height = game.getBoardSize();
+    const TexelRect& area = region ? *region : all;
+
+    for (int row = area.y; row < area.y + area.height; row++) {
+        for (int col = area.x; col < area.x + area.width; col++) {
+            if (game.getCell(row, col) == INVALID)
+                continue;
+
+            QuadInstance cell;
+            cell.center = cellCenter(game, theme, row, col);
+            cell.size = cellSize * theme.CELL_SCALE_FACTOR;
+            cell.depth = 0.0f;
+            cell.color = theme.BOARD_COLOR;
+            cells.push_back(cell);
+        }
+    }
+}
+
+void BoardLayout::buildMarbles(const MarbleSolitaire& game, const Theme& theme, const TexelRect* region) {
+    marbles.clear();
+    float cellSize = theme.BOARD_WIDTH / game.getBoardSize();
+    TexelRect all;
+    all.width = all.height = game.getBoardSize();
+    const TexelRect& area = region ? *region : all;
+
+    for (int row = area.y; row < area.y + area.height; row++) {
+        for (int col = area.x; col < area.x + area.width; col++) {
+            if (game.getCell(row, col) != MARBLE || isHidden(row, col))
+                continue;
+
+            QuadInstance marble;
+            marble.center = cellCenter(game, theme, row, col);
+            marble.size = cellSize * theme.MARBLE_SCALE_FACTOR;
+            marble.depth = theme.MARBLE_Z_POSITION;
+            marble.color = theme.MARBLE_COLOR;
+            marbles.push_back(marble);
+        }
+    }
+}
+
+void BoardLayout::buildHighlights(const MarbleSolitaire& game, const Theme& theme, const Position* positions,
+                                  int count, const glm::vec4& color) {
+    highlights.clear();
+    float cellSize = theme.BOARD_WIDTH / game.getBoardSize();
+    for (int i = 0; i < count; i++) {
+        // Slightly above the board but below marbles
+        QuadInstance square;
+        square.center = cellCenter(game, theme, positions[i].row, positions[i].col);
+        square.size = cellSize * (theme.CELL_SCALE_FACTOR + 0.05f);
+        square.depth = 0.05f;
+        square.color = color;
+        highlights.push_back(square);
+    }
+}
+
+// Winnable beats still being searched, which beats dead
+static int verdictRank(MoveQuality quality) {
+    return quality == MOVE_WINNABLE ? 2 : quality == MOVE_PENDING ? 1 : 0;
+}
+
+void BoardLayout::buildMoveOverlay(const MarbleSolitaire& game, const Theme& theme, const BoardShape& shape,
+                                   const std::vector<MoveEvaluation>& evaluations) {
+    overlay.clear();
+    ringAt.assign(64, -1);
+    best.clear();
+    bestCount.clear();
+
+    Position selected = game.getSelectedPosition();
+    int selectedHole = selected.isValid() ? shape.index(selected.row, selected.col) : -1;
+    float size = theme.BOARD_WIDTH / game.getBoardSize() * theme.OVERLAY_SCALE_FACTOR;
+
+    // Strength is relative to the most forgiving move on the board, on a log scale
+    SolutionCount most = 0;
+    for (const MoveEvaluation& evaluation : evaluations) {
+        most = std::max(most, evaluation.solutions);
+    }
+    double mostLog = std::log1p(static_cast<double>(most));
+
+    for (const MoveEvaluation& evaluation : evaluations) {
+        const Jump& jump = shape.getJumps()[evaluation.jump];
+        if (selectedHole >= 0 && jump.from != selectedHole) continue;
+        int hole = selectedHole >= 0 ? jump.to : jump.from;
+
+        int index = ringAt[hole];
+        if (index < 0) {
+            Position cell = shape.position(hole);
+            QuadInstance ring;
+            ring.center = cellCenter(game, theme, cell.row, cell.col);
+            ring.size = size;
+            ring.depth = 0.06f;
+            index = ringAt[hole] = static_cast<int>(overlay.size());
+            overlay.push_back(ring);
+            best.push_back(evaluation.quality);
+            bestCount.push_back(evaluation.solutions);
+        } else if (verdictRank(evaluation.quality) > verdictRank(best[index]) ||
+                   (evaluation.quality == best[index] && evaluation.solutions > bestCount[index])) {
+            best[index] = evaluation.quality;
+            bestCount[index] = evaluation.solutions;
+        }
+    }
+
+    for (size_t i = 0; i < overlay.size(); i++) {
+        glm::vec4 color = best[i] == MOVE_WINNABLE ? theme.WINNABLE_COLOR
+                        : best[i] == MOVE_DEAD ? theme.DEAD_COLOR : theme.PENDING_COLOR;
+        if (best[i] == MOVE_WINNABLE && mostLog > 0.0) {
+            color.a *= 0.4f + 0.6f * static_cast<float>(std::log1p(static_cast<double>(bestCount[i])) / mostLog);
+        }
+        overlay[i].color = color;
+    }
+}
+
+void BoardLayout::buildTexels(const MarbleSolitaire& game, const Move& hint) {
+    int size = game.getBoardSize();
+    bool resized = size != texelSize;
+    if (resized) {
+        texels.assign(size * size, 0);
+        texelSize = size;
+    }
+
+    Position selected = game.getSelectedPosition();
+    int minRow = size, maxRow = -1, minCol = size, maxCol = -1;
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            CellState cell = game.getCell(row, col);
+            uint8_t value = 0;
+            if (cell != INVALID) {
+                Position here(row, col);
+                value = TEXEL_HOLE;
+                if (cell == MARBLE && !isHidden(row, col)) value |= TEXEL_MARBLE;
+                if (here == selected) value |= TEXEL_SELECTED;
+                if (here == hint.from || here == hint.to) value |= TEXEL_HINT;
+            }
+
+            uint8_t& texel = texels[row * size + col];
+            if (texel != value || resized) {
+                texel = value;
+                minRow = std::min(minRow, row);
+                maxRow = std::max(maxRow, row);
+                minCol = std::min(minCol, col);
+                maxCol = std::max(maxCol, col);
+            }
+        }
+    }
+
+    dirtyTexels = TexelRect();
+    if (maxRow >= 0) {
+        dirtyTexels.x = minCol;
+        dirtyTexels.y = minRow;
+        dirtyTexels.width = maxCol - minCol + 1;
+        dirtyTexels.height = maxRow - minRow + 1;
+    }
+}
+
+void BoardLayout::buildMarbleSprite(int size, std::vector<uint8_t>& texels) {
+    texels.assign(size * size * 2, 0);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            // Same maths as circle.fs, at the texel centre
+            float u = (x + 0.5f) / size - 0.5f;
+            float v = (y + 0.5f) / size - 0.5f;
+            float dist = std::sqrt(u * u + v * v);
+            if (dist > 0.45f) continue;
+
+            float brightness = 1.0f - dist * 1.5f;
+            brightness += std::pow(1.0f - dist, 3.0f) * 0.4f;
+            brightness = std::max(brightness, 0.3f);
+
+            uint8_t* texel = &texels[(y * size + x) * 2];
+            texel[0] = static_cast<uint8_t>(std::min(brightness * 0.5f, 1.0f) * 255.0f + 0.5f);
+            texel[1] = 255;
+        }
+    }
+}
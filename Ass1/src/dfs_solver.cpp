@@ -0,0 +1,92 @@
+#include "dfs_solver.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+DfsSolver::DfsSolver(const BoardShape& boardShape, MoveOrderer& moveOrderer, size_t tableMegabytes)
+    : shape(boardShape), orderer(moveOrderer), table(tableMegabytes), goalMask(boardShape.getHoles()),
+      symmetryMask(BoardShape::ALL_SYMMETRIES), nodes(0), maxNodes(0), solved(false),
+      arena((boardShape.getJumps().size() + 1) * (boardShape.getHoleCount() + 1) * sizeof(int) + 4096) {
+}
+
+DfsResult DfsSolver::solve(Bitboard start, int goalHole, uint64_t nodeLimit) {
+    DfsResult result;
+    goalMask = goalHole < 0 ? shape.getHoles() : (Bitboard(1) << goalHole);
+    symmetryMask = shape.stabilizer(goalMask);
+    table.clear();
+    orderer.reset();
+    nodes = 0;
+    maxNodes = nodeLimit;
+    solved = false;
+
+    // A line never has more jumps than holes, and a ply never more than every jump
+    arena.reset();
+    jumps.attach(arena, shape.getJumps().size() * (shape.getHoleCount() + 1));
+    line.attach(arena, shape.getHoleCount());
+
+    auto startTime = std::chrono::steady_clock::now();
+    search(BoardState::from(start));
+
+    result.solved = solved;
+    result.aborted = !solved && maxNodes && nodes >= maxNodes;
+    if (solved) {
+        result.line.assign(line.begin(), line.end());
+    }
+    result.nodes = nodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+int DfsSolver::search(const BoardState& state) {
+    nodes++;
+
+    if (state.pegCount == 1) {
+        solved = (state.pegs & goalMask) != 0;
+        return 1;
+    }
+    if (maxNodes && nodes >= maxNodes) {
+        return state.pegCount;
+    }
+
+    // Dead ends remember how close they got, so the orderer still learns from them
+    Bitboard key = shape.canonical(state.pegs, symmetryMask);
+    int fewestPegs;
+    if (table.probe(key, fewestPegs)) {
+        return fewestPegs;
+    }
+
+    size_t first = jumps.size();
+    Bitboard movers = state.pegs;
+    while (movers) {
+        int hole = lowestBit(movers);
+        movers &= movers - 1;
+        for (int id : shape.jumpsFrom(hole)) {
+            if (state.canPlay(shape.getJumps()[id])) {
+                jumps.push(id);
+            }
+        }
+    }
+    orderer.order(state, jumps.begin() + first, static_cast<int>(jumps.size() - first));
+
+    fewestPegs = state.pegCount;
+    for (size_t i = first; i < jumps.size(); i++) {
+        int id = jumps[i];
+        line.push(id);
+        int reached = search(state.played(shape.getJumps()[id]));
+        if (solved) {
+            return reached;
+        }
+        line.pop();
+
+        orderer.searched(state.depth, id, reached);
+        fewestPegs = std::min(fewestPegs, reached);
+        if (maxNodes && nodes >= maxNodes) {
+            jumps.truncate(first);
+            return fewestPegs;
+        }
+    }
+    jumps.truncate(first);
+
+    table.store(key, fewestPegs, state.pegCount);
+    return fewestPegs;
+}
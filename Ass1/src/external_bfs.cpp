@@ -0,0 +1,343 @@
+#include "external_bfs.h"
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <sys/stat.h>
+#include <utility>
+
+BoardRunWriter::BoardRunWriter(const std::string& path, size_t bufferBytes)
+    : file(std::fopen(path.c_str(), "wb")), buffer(std::max(bufferBytes, size_t(64))), used(0),
+      previous(0), count(0) {
+}
+
+BoardRunWriter::~BoardRunWriter() {
+    close();
+}
+
+void BoardRunWriter::write(Bitboard pegs) {
+    // A varint never takes more than ten bytes
+    if (used + 10 > buffer.size()) {
+        flush();
+    }
+
+    Bitboard delta = pegs - previous;
+    previous = pegs;
+    do {
+        unsigned char byte = delta & 0x7F;
+        delta >>= 7;
+        buffer[used++] = byte | (delta ? 0x80 : 0);
+    } while (delta);
+    count++;
+}
+
+void BoardRunWriter::flush() {
+    if (file && used) {
+        std::fwrite(buffer.data(), 1, used, file);
+    }
+    used = 0;
+}
+
+bool BoardRunWriter::close() {
+    if (!file) {
+        return false;
+    }
+    flush();
+    bool ok = std::ferror(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    return ok;
+}
+
+BoardRunReader::BoardRunReader(const std::string& path, size_t bufferBytes)
+    : file(std::fopen(path.c_str(), "rb")), buffer(std::max(bufferBytes, size_t(64))), used(0),
+      available(0), previous(0), error(false) {
+}
+
+BoardRunReader::~BoardRunReader() {
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool BoardRunReader::fill() {
+    // Keep any partial varint at the front and read a large block after it
+    size_t remaining = available - used;
+    std::copy(buffer.begin() + used, buffer.begin() + available, buffer.begin());
+    used = 0;
+    available = remaining + std::fread(buffer.data() + remaining, 1, buffer.size() - remaining, file);
+    if (std::ferror(file)) {
+        error = true;
+    }
+    return available > remaining;
+}
+
+bool BoardRunReader::next(Bitboard& pegs) {
+    if (!file) {
+        return false;
+    }
+    if (available - used < 10 && !fill() && used == available) {
+        return false;
+    }
+    if (error) {
+        return false;
+    }
+
+    Bitboard delta = 0;
+    int shift = 0;
+    while (used < available) {
+        unsigned char byte = buffer[used++];
+        delta |= Bitboard(byte & 0x7F) << shift;
+        shift += 7;
+        if (!(byte & 0x80)) {
+            previous += delta;
+            pegs = previous;
+            return true;
+        }
+    }
+    error = true;
+    return false;
+}
+
+ExternalBfs::ExternalBfs(const BoardShape& boardShape, const ExternalBfsConfig& bfsConfig)
+    : shape(boardShape), config(bfsConfig), symmetryMask(1) {
+}
+
+std::string ExternalBfs::layerPath(int pegs) const {
+    return config.directory + "/layer_" + std::to_string(pegs) + ".dat";
+}
+
+std::string ExternalBfs::runPath(int pegs, int run) const {
+    return config.directory + "/layer_" + std::to_string(pegs) + ".run" + std::to_string(run);
+}
+
+std::string ExternalBfs::checkpointPath() const {
+    return config.directory + "/checkpoint.txt";
+}
+
+bool ExternalBfs::run(Bitboard start) {
+    if (mkdir(config.directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "Cannot create " << config.directory << std::endl;
+        return false;
+    }
+
+    symmetryMask = config.useSymmetry ? shape.stabilizer(start) : 1;
+    int startPegs = popCount(start);
+    layerCounts.assign(startPegs + 1, 0);
+
+    int pegs = startPegs;
+    if (loadCheckpoint(start, pegs)) {
+        std::cout << "Resuming from the " << pegs << "-marble layer" << std::endl;
+    } else if (!writeStartLayer(start) || !saveCheckpoint(start, startPegs)) {
+        return false;
+    }
+
+    while (pegs > 1 && layerCounts[pegs] > 0) {
+        std::vector<std::string> runs;
+        if (!expandLayer(pegs, runs)) {
+            return false;
+        }
+
+        // Merge into a temporary file first so a crash never leaves a half layer
+        std::string output = layerPath(pegs - 1);
+        uint64_t count = 0;
+        if (!mergeRuns(runs, output + ".tmp", count) ||
+            std::rename((output + ".tmp").c_str(), output.c_str()) != 0) {
+            std::cerr << "Failed to write " << output << std::endl;
+            return false;
+        }
+
+        pegs--;
+        layerCounts[pegs] = count;
+        if (!saveCheckpoint(start, pegs)) {
+            return false;
+        }
+        std::cout << "Layer " << pegs << ": " << count << " positions" << std::endl;
+    }
+    return true;
+}
+
+bool ExternalBfs::loadCheckpoint(Bitboard start, int& lastLayer) {
+    std::ifstream in(checkpointPath().c_str());
+    if (!in.is_open()) {
+        return false;
+    }
+
+    std::string key;
+    Bitboard savedStart = 0;
+    int savedSymmetry = -1;
+    int lowest = -1;
+    while (in >> key) {
+        if (key == "start") {
+            in >> std::hex >> savedStart >> std::dec;
+        } else if (key == "symmetry") {
+            in >> savedSymmetry;
+        } else if (key == "layer") {
+            int pegs;
+            uint64_t count;
+            in >> pegs >> count;
+            if (pegs >= 0 && pegs < static_cast<int>(layerCounts.size())) {
+                layerCounts[pegs] = count;
+                lowest = lowest < 0 ? pegs : std::min(lowest, pegs);
+            }
+        }
+    }
+
+    if (savedStart != start || savedSymmetry != symmetryMask || lowest < 0) {
+        std::cout << "Ignoring checkpoint for a different enumeration" << std::endl;
+        layerCounts.assign(layerCounts.size(), 0);
+        return false;
+    }
+    lastLayer = lowest;
+    return true;
+}
+
+bool ExternalBfs::saveCheckpoint(Bitboard start, int lastLayer) {
+    std::string path = checkpointPath();
+    {
+        std::ofstream out((path + ".tmp").c_str());
+        out << "start " << std::hex << start << std::dec << "\n";
+        out << "symmetry " << symmetryMask << "\n";
+        for (int pegs = static_cast<int>(layerCounts.size()) - 1; pegs >= lastLayer; pegs--) {
+            out << "layer " << pegs << " " << layerCounts[pegs] << "\n";
+        }
+        if (!out.good()) {
+            std::cerr << "Failed to write checkpoint" << std::endl;
+            return false;
+        }
+    }
+    return std::rename((path + ".tmp").c_str(), path.c_str()) == 0;
+}
+
+bool ExternalBfs::writeStartLayer(Bitboard start) {
+    BoardRunWriter writer(layerPath(popCount(start)), config.ioBufferBytes);
+    writer.write(shape.canonical(start, symmetryMask));
+    layerCounts[popCount(start)] = 1;
+    return writer.close();
+}
+
+bool ExternalBfs::expandLayer(int pegs, std::vector<std::string>& runs) {
+    BoardRunReader reader(layerPath(pegs), config.ioBufferBytes);
+    if (!reader.isOpen()) {
+        std::cerr << "Missing layer file " << layerPath(pegs) << std::endl;
+        return false;
+    }
+
+    // Whatever the budget leaves after the reader and writer buffers
+    size_t reserved = 2 * config.ioBufferBytes;
+    size_t capacity = config.memoryBytes > reserved ? (config.memoryBytes - reserved) / sizeof(Bitboard) : 0;
+    capacity = std::max(capacity, size_t(1024));
+
+    std::vector<Bitboard> pending;
+    pending.reserve(capacity);
+
+    const std::vector<Jump>& jumps = shape.getJumps();
+    Bitboard board;
+    while (reader.next(board)) {
+        if (pending.size() + jumps.size() > capacity) {
+            runs.push_back(runPath(pegs - 1, static_cast<int>(runs.size())));
+            if (!writeRun(pending, runs.back())) return false;
+        }
+        for (const Jump& jump : jumps) {
+            if (canJump(board, jump)) {
+                pending.push_back(shape.canonical(applyJump(board, jump), symmetryMask));
+            }
+        }
+    }
+
+    if (reader.failed()) {
+        std::cerr << "Cannot read layer file " << layerPath(pegs) << std::endl;
+        return false;
+    }
+
+    runs.push_back(runPath(pegs - 1, static_cast<int>(runs.size())));
+    return writeRun(pending, runs.back());
+}
+
+bool ExternalBfs::writeRun(std::vector<Bitboard>& boards, const std::string& path) {
+    std::sort(boards.begin(), boards.end());
+    boards.erase(std::unique(boards.begin(), boards.end()), boards.end());
+
+    BoardRunWriter writer(path, config.ioBufferBytes);
+    for (Bitboard board : boards) {
+        writer.write(board);
+    }
+    boards.clear();
+    return writer.close();
+}
+
+bool ExternalBfs::mergeRuns(const std::vector<std::string>& runs, const std::string& output, uint64_t& count) {
+    // Fan-in is limited by how many read buffers fit in the budget; larger
+    // sets are merged in several passes through intermediate runs. Each pass
+    // names its runs after its level, so no pass writes a file it still reads.
+    size_t fanIn = std::max(size_t(2), config.memoryBytes / config.ioBufferBytes - 1);
+    std::vector<std::string> current = runs;
+    for (int level = 0; current.size() > fanIn; level++) {
+        std::vector<std::string> merged;
+        for (size_t first = 0; first < current.size(); first += fanIn) {
+            std::vector<std::string> group(current.begin() + first,
+                                           current.begin() + std::min(first + fanIn, current.size()));
+            merged.push_back(output + ".pass" + std::to_string(level) + "." + std::to_string(merged.size()));
+            uint64_t ignored;
+            if (!mergeGroup(group, merged.back(), ignored)) return false;
+        }
+        current.swap(merged);
+    }
+    return mergeGroup(current, output, count);
+}
+
+bool ExternalBfs::mergeGroup(const std::vector<std::string>& runs, const std::string& output, uint64_t& count) {
+    std::vector<BoardRunReader*> readers;
+    typedef std::pair<Bitboard, size_t> HeapEntry;
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry> > heap;
+    for (size_t i = 0; i < runs.size(); i++) {
+        readers.push_back(new BoardRunReader(runs[i], config.ioBufferBytes));
+        if (!readers[i]->isOpen()) {
+            std::cerr << "Cannot open run " << runs[i] << std::endl;
+            for (BoardRunReader* reader : readers) delete reader;
+            return false;
+        }
+        Bitboard board;
+        if (readers[i]->next(board)) {
+            heap.push(HeapEntry(board, i));
+        }
+    }
+
+    BoardRunWriter writer(output, config.ioBufferBytes);
+    bool first = true;
+    Bitboard last = 0;
+    while (!heap.empty()) {
+        HeapEntry top = heap.top();
+        heap.pop();
+        if (first || top.first != last) {
+            writer.write(top.first);
+            last = top.first;
+            first = false;
+        }
+        Bitboard board;
+        if (readers[top.second]->next(board)) {
+            heap.push(HeapEntry(board, top.second));
+        }
+    }
+
+    // A run that could not be read in full would silently drop positions;
+    // the runs are only deleted once everything in them reached the output
+    bool ok = true;
+    for (size_t i = 0; i < readers.size(); i++) {
+        if (readers[i]->failed()) {
+            std::cerr << "Cannot read run " << runs[i] << std::endl;
+            ok = false;
+        }
+    }
+    for (size_t i = 0; i < readers.size(); i++) {
+        delete readers[i];
+        if (ok) {
+            std::remove(runs[i].c_str());
+        }
+    }
+
+    count = writer.getCount();
+    return writer.close() && ok;
+}
@@ -1,7 +1,8 @@
 #include "game.h"
 #include <iostream>
 
-MarbleSolitaire::MarbleSolitaire(int size) : boardSize(size), remainingMarbles(0), selectedPosition(-1, -1) {
+MarbleSolitaire::MarbleSolitaire(int size)
+    : boardSize(size), remainingMarbles(0), selectedPosition(-1, -1), recordMoveEvents(false) {
     // Initialize board
     board.resize(boardSize, std::vector<CellState>(boardSize, INVALID));
     reset();
@@ -19,6 +20,7 @@ void MarbleSolitaire::reset() {
 
     // Initialize board
     initializeBoard();
+    recordEvent(BOARD_RESET, Move());
 
     // Calculate initial marble count
     remainingMarbles = 0;
@@ -219,6 +221,7 @@ bool MarbleSolitaire::makeMove(int fromRow, int fromCol, int toRow, int toCol) {
     move.to = Position(toRow, toCol);
     move.jumped = Position(midRow, midCol);
     moveHistory.push(move);
+    recordEvent(MOVE_PLAYED, move);
 
     // Clear redo stack since we made a new move
     while (!redoStack.empty()) {
@@ -444,6 +447,7 @@ bool MarbleSolitaire::undoMove() {
 
     // Add to redo stack
     redoStack.push(lastMove);
+    recordEvent(MOVE_UNDONE, lastMove);
 
     // Update remaining marbles
     remainingMarbles++;
@@ -477,6 +481,7 @@ bool MarbleSolitaire::redoMove() {
 
     // Add to history
     moveHistory.push(redoMove);
+    recordEvent(MOVE_PLAYED, redoMove);
 
     // Update remaining marbles
     remainingMarbles--;
@@ -492,6 +497,21 @@ bool MarbleSolitaire::redoMove() {
 
     return true;
 }
+void MarbleSolitaire::recordEvent(MoveEventKind kind, const Move& move) {
+    if (!recordMoveEvents) return;
+    // A reset makes everything before it moot
+    if (kind == BOARD_RESET) moveEvents.clear();
+    MoveEvent event;
+    event.kind = kind;
+    event.move = move;
+    moveEvents.push_back(event);
+}
+
+void MarbleSolitaire::takeMoveEvents(std::vector<MoveEvent>& out) {
+    out.swap(moveEvents);
+    moveEvents.clear();
+}
+
 bool MarbleSolitaire::gameOver() const {
     // Game is over if there are no valid moves left
     return !hasValidMoves();
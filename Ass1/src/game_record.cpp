@@ -0,0 +1,268 @@
+#include "game_record.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint32_t RECORD_VERSION = 1;
+
+// Writes the 8-byte file header if the file is new, and returns its size
+bool prepare(std::FILE* file, const char* magic, uint64_t& size) {
+    if (std::fseek(file, 0, SEEK_END) != 0) return false;
+    long end = std::ftell(file);
+    if (end < 0) return false;
+    if (end == 0) {
+        std::fwrite(magic, 1, 4, file);
+        std::fwrite(&RECORD_VERSION, sizeof(RECORD_VERSION), 1, file);
+        end = 8;
+    }
+    size = static_cast<uint64_t>(end);
+    return std::ferror(file) == 0;
+}
+
+// Whether the record at offset lies wholly inside the file and replays on its
+// board; end is set to the byte after it
+bool replaysAt(int fd, uint64_t offset, uint64_t size, uint64_t& end) {
+    GameRecordHeader header;
+    if (offset < 8 || offset + sizeof(header) > size ||
+        pread(fd, &header, sizeof(header), offset) != static_cast<ssize_t>(sizeof(header)) ||
+        header.shape > RECORD_FRENCH || offset + sizeof(header) + header.jumps > size) {
+        return false;
+    }
+    uint8_t ids[256];
+    if (pread(fd, ids, header.jumps, offset + sizeof(header)) != header.jumps) {
+        return false;
+    }
+    BoardShape shape = shapeForRecord(header.shape);
+    const std::vector<Jump>& jumps = shape.getJumps();
+    Bitboard pegs = header.start;
+    if ((pegs & ~shape.getHoles()) != 0) {
+        return false;
+    }
+    for (int i = 0; i < header.jumps; i++) {
+        if (ids[i] >= jumps.size() || !canJump(pegs, jumps[ids[i]])) {
+            return false;
+        }
+        pegs = applyJump(pegs, jumps[ids[i]]);
+    }
+    end = offset + sizeof(header) + header.jumps;
+    return true;
+}
+
+// A crash can leave either file ending in a torn write. Appending after that
+// would put new index entries at unaligned offsets, or new records behind
+// junk. Cuts the index back to whole entries whose records replay, and the
+// records back to the end of the last of them.
+bool cutTornTail(const std::string& path) {
+    int data = ::open(path.c_str(), O_RDWR);
+    int index = ::open((path + ".idx").c_str(), O_RDWR);
+    struct stat dataInfo, indexInfo;
+    bool ok = true;
+    if (data >= 0 && index >= 0 && fstat(data, &dataInfo) == 0 && fstat(index, &indexInfo) == 0) {
+        uint64_t dataSize = static_cast<uint64_t>(dataInfo.st_size);
+        uint64_t indexSize = static_cast<uint64_t>(indexInfo.st_size);
+        uint64_t entries = indexSize >= 8 ? (indexSize - 8) / sizeof(uint64_t) : 0;
+        uint64_t end = 8;
+        for (; entries > 0; entries--) {
+            uint64_t offset;
+            if (pread(index, &offset, sizeof(offset), 8 + (entries - 1) * sizeof(offset)) ==
+                    static_cast<ssize_t>(sizeof(offset)) &&
+                replaysAt(data, offset, dataSize, end)) {
+                break;
+            }
+        }
+        // A file header cut short is written again by prepare()
+        uint64_t indexEnd = indexSize >= 8 ? 8 + entries * sizeof(uint64_t) : 0;
+        uint64_t dataEnd = dataSize >= 8 ? end : 0;
+        if (indexEnd != indexSize) ok = ftruncate(index, static_cast<off_t>(indexEnd)) == 0;
+        if (dataEnd != dataSize) ok = ftruncate(data, static_cast<off_t>(dataEnd)) == 0 && ok;
+    }
+    // A new file, or records without an index: nothing to line up
+    if (data >= 0) ::close(data);
+    if (index >= 0) ::close(index);
+    return ok;
+}
+
+const uint8_t* mapFile(const std::string& path, const char* magic, size_t& bytes) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat info;
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= 8) {
+        bytes = static_cast<size_t>(info.st_size);
+        memory = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) return nullptr;
+
+    const uint8_t* mapped = static_cast<const uint8_t*>(memory);
+    uint32_t version;
+    std::memcpy(&version, mapped + 4, sizeof(version));
+    if (std::memcmp(mapped, magic, 4) != 0 || version != RECORD_VERSION) {
+        std::cerr << "Not a version " << RECORD_VERSION << " " << magic << " file: " << path << std::endl;
+        munmap(memory, bytes);
+        return nullptr;
+    }
+    // Records are read front to back far more often than at random
+    madvise(memory, bytes, MADV_SEQUENTIAL);
+    return mapped;
+}
+
+} // namespace
+
+bool recordShapeFor(const BoardShape& shape, uint8_t& id) {
+    if (shape.getName() == "english") {
+        id = RECORD_ENGLISH;
+    } else if (shape.getName() == "french") {
+        id = RECORD_FRENCH;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+BoardShape shapeForRecord(uint8_t id) {
+    return id == RECORD_FRENCH ? BoardShape::french() : BoardShape::english();
+}
+
+GameRecordWriter::GameRecordWriter(const std::string& path)
+    : data(nullptr), index(nullptr), offset(0), count(0), failed(false) {
+    if (cutTornTail(path)) {
+        data = std::fopen(path.c_str(), "ab");
+        index = std::fopen((path + ".idx").c_str(), "ab");
+    }
+    uint64_t indexBytes = 0;
+    if (!data || !index || !prepare(data, "MSGR", offset) || !prepare(index, "MSGI", indexBytes)) {
+        std::cerr << "Cannot append to game records " << path << std::endl;
+        failed = true;
+        return;
+    }
+    count = (indexBytes - 8) / sizeof(uint64_t);
+}
+
+GameRecordWriter::~GameRecordWriter() {
+    close();
+}
+
+bool GameRecordWriter::append(const GameRecordHeader& header, const uint8_t* jumps) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (!data || !index || failed) {
+        return false;
+    }
+
+    // The record reaches the file before its index entry is even buffered, so
+    // an index entry never points past the records written
+    std::fwrite(&header, sizeof(header), 1, data);
+    std::fwrite(jumps, 1, header.jumps, data);
+    std::fflush(data);
+    std::fwrite(&offset, sizeof(offset), 1, index);
+    offset += sizeof(header) + header.jumps;
+    count++;
+    failed = std::ferror(data) != 0 || std::ferror(index) != 0;
+    return !failed;
+}
+
+bool GameRecordWriter::close() {
+    std::lock_guard<std::mutex> guard(lock);
+    bool ok = !failed;
+    if (data) {
+        ok = std::fclose(data) == 0 && ok;
+        data = nullptr;
+    }
+    if (index) {
+        ok = std::fclose(index) == 0 && ok;
+        index = nullptr;
+    }
+    return ok;
+}
+
+GameRecordReader::GameRecordReader(const std::string& path)
+    : data(nullptr), dataBytes(0), offsets(nullptr), indexBytes(0), indexMapping(nullptr), count(0),
+      cursor(HEADER_BYTES), shapes{BoardShape::english(), BoardShape::french()} {
+    data = mapFile(path, "MSGR", dataBytes);
+    if (!data) {
+        std::cerr << "Cannot read game records " << path << std::endl;
+        return;
+    }
+
+    indexMapping = mapFile(path + ".idx", "MSGI", indexBytes);
+    if (indexMapping) {
+        offsets = reinterpret_cast<const uint64_t*>(indexMapping + 8);
+        count = (indexBytes - 8) / sizeof(uint64_t);
+
+        // Drop index entries whose record did not make it to disk
+        GameRecordView view;
+        while (count > 0 && !readAt(offsets[count - 1], view)) {
+            count--;
+        }
+        return;
+    }
+
+    // No index: find every record once, after which access is O(1) as well
+    GameRecordView view;
+    for (uint64_t at = HEADER_BYTES; readAt(at, view); at += sizeof(GameRecordHeader) + view.header.jumps) {
+        scanned.push_back(at);
+    }
+    count = scanned.size();
+}
+
+GameRecordReader::~GameRecordReader() {
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), dataBytes);
+    }
+    if (indexMapping) {
+        munmap(const_cast<uint8_t*>(indexMapping), indexBytes);
+    }
+}
+
+bool GameRecordReader::readAt(uint64_t offset, GameRecordView& view) const {
+    if (offset < HEADER_BYTES || offset + sizeof(GameRecordHeader) > dataBytes) {
+        return false;
+    }
+    // Records are packed, so a header is copied out rather than read in place
+    std::memcpy(&view.header, data + offset, sizeof(GameRecordHeader));
+    view.jumps = data + offset + sizeof(GameRecordHeader);
+    return offset + sizeof(GameRecordHeader) + view.header.jumps <= dataBytes;
+}
+
+bool GameRecordReader::get(uint64_t n, GameRecordView& view) const {
+    if (n >= count) {
+        return false;
+    }
+    return readAt(offsets ? offsets[n] : scanned[n], view);
+}
+
+bool GameRecordReader::next(GameRecordView& view) {
+    if (!data || !readAt(cursor, view)) {
+        return false;
+    }
+    cursor += sizeof(GameRecordHeader) + view.header.jumps;
+    return true;
+}
+
+bool GameRecordReader::validate(const GameRecordView& view, Bitboard& pegs) const {
+    const GameRecordHeader& header = view.header;
+    if (header.shape > RECORD_FRENCH) {
+        return false;
+    }
+    const BoardShape& shape = shapes[header.shape];
+    const std::vector<Jump>& jumps = shape.getJumps();
+
+    pegs = header.start;
+    if ((pegs & ~shape.getHoles()) != 0) {
+        return false;
+    }
+    for (int i = 0; i < header.jumps; i++) {
+        if (view.jumps[i] >= jumps.size() || !canJump(pegs, jumps[view.jumps[i]])) {
+            return false;
+        }
+        pegs = applyJump(pegs, jumps[view.jumps[i]]);
+    }
+    return true;
+}
@@ -0,0 +1,142 @@
+#include "hint_client.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+HintClient::HintClient() : fd(-1), consumed(0) {
+}
+
+HintClient::~HintClient() {
+    disconnect();
+}
+
+bool HintClient::connect(const std::string& socketPath) {
+    disconnect();
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        disconnect();
+        return false;
+    }
+    return true;
+}
+
+void HintClient::disconnect() {
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    fd = -1;
+    input.clear();
+    consumed = 0;
+}
+
+bool HintClient::send(const HintRequest& request) {
+    return send(std::vector<HintRequest>(1, request));
+}
+
+bool HintClient::send(const std::vector<HintRequest>& requests) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(requests.data());
+    size_t size = requests.size() * sizeof(HintRequest);
+    for (size_t sent = 0; sent < size;) {
+        if (fd < 0) {
+            return false;
+        }
+        ssize_t written = ::send(fd, bytes + sent, size - sent, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            disconnect();
+            return false;
+        }
+        sent += written;
+    }
+    return true;
+}
+
+bool HintClient::takeResponse(HintResponse& response) {
+    size_t available = input.size() - consumed;
+    if (available < size_t(HINT_RESPONSE_HEADER)) {
+        return false;
+    }
+    size_t size = HINT_RESPONSE_HEADER + input[consumed + offsetof(HintResponse, jumps)];
+    if (available < size) {
+        return false;
+    }
+
+    std::memcpy(&response, input.data() + consumed, size);
+    consumed += size;
+    if (consumed == input.size()) {
+        input.clear();
+        consumed = 0;
+    }
+    return true;
+}
+
+bool HintClient::readSome(bool wait) {
+    if (fd < 0) {
+        return false;
+    }
+
+    // Drop what was handed out before growing the buffer
+    if (consumed > 0) {
+        input.erase(input.begin(), input.begin() + consumed);
+        consumed = 0;
+    }
+
+    uint8_t buffer[1 << 14];
+    ssize_t received;
+    do {
+        received = recv(fd, buffer, sizeof(buffer), wait ? 0 : MSG_DONTWAIT);
+    } while (received < 0 && errno == EINTR);
+
+    if (received > 0) {
+        input.insert(input.end(), buffer, buffer + received);
+        return true;
+    }
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return false;
+    }
+    disconnect();
+    return false;
+}
+
+bool HintClient::receive(HintResponse& response) {
+    while (!takeResponse(response)) {
+        if (!readSome(true)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HintClient::poll(HintResponse& response) {
+    if (takeResponse(response)) {
+        return true;
+    }
+    return readSome(false) && takeResponse(response);
+}
+
+bool HintClient::query(const HintRequest& request, HintResponse& response) {
+    if (!send(request)) {
+        return false;
+    }
+    while (receive(response)) {
+        if (response.id == request.id) {
+            return true;
+        }
+    }
+    return false;
+}
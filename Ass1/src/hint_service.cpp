@@ -0,0 +1,328 @@
+#include "hint_service.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+#include "game_record.h"
+
+static_assert(offsetof(HintResponse, line) == HINT_RESPONSE_HEADER, "the line follows the header on the wire");
+
+namespace {
+
+// Table entries untouched for this long are the first to be replaced. Aging
+// per request would make the warm cache stale as fast as it fills.
+const int64_t AGE_INTERVAL_MILLIS = 10000;
+
+volatile std::sig_atomic_t signalled = 0;
+
+void onSignal(int) {
+    signalled = 1;
+}
+
+} // namespace
+
+HintService::HintService(size_t tableMegabytes, size_t memo) : memoMegabytes(memo) {
+    boards[RECORD_ENGLISH].reset(new Board(BoardShape::english(), tableMegabytes));
+    boards[RECORD_FRENCH].reset(new Board(BoardShape::french(), tableMegabytes));
+}
+
+bool HintService::setBook(const OpeningBook* book) {
+    uint8_t id;
+    if (!recordShapeFor(book->getShape(), id)) {
+        return false;
+    }
+    boards[id]->book = book;
+    boards[id]->oracle.setBook(book);
+    return true;
+}
+
+void HintService::age(Board& board) {
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t last = board.agedAt.load(std::memory_order_relaxed);
+    // Only the thread that moves the clock on ages the table
+    if (now - last >= AGE_INTERVAL_MILLIS && board.agedAt.compare_exchange_strong(last, now)) {
+        board.oracle.newSearch();
+    }
+}
+
+void HintService::answer(const HintRequest& request, HintResponse& response) {
+    response.id = request.id;
+    response.op = request.op;
+    response.status = HINT_OK;
+    response.jumps = 0;
+    response.reserved = 0;
+    response.countLow = response.countHigh = 0;
+
+    if (request.shape > RECORD_FRENCH || request.pegs == 0 ||
+        (request.pegs & ~boards[request.shape]->oracle.getShape().getHoles()) != 0) {
+        response.status = HINT_BAD_REQUEST;
+        return;
+    }
+    Board& board = *boards[request.shape];
+    SolvabilityOracle& oracle = board.oracle;
+    age(board);
+
+    switch (request.op) {
+        case HINT_OP_IS_SOLVABLE:
+            response.countLow = oracle.solvable(request.pegs);
+            break;
+
+        case HINT_OP_COUNT: {
+            OpeningBookHit hit;
+            if (board.book && board.book->hasCounts() && board.book->lookup(request.pegs, hit)) {
+                response.countLow = static_cast<uint64_t>(hit.solutions);
+                response.countHigh = static_cast<uint64_t>(hit.solutions >> 64);
+                break;
+            }
+            std::call_once(board.counterCreated, [&]() {
+                board.counter.reset(new SolutionCounter(oracle.getShape(), memoMegabytes));
+                board.counter->setBook(board.book);
+            });
+            SolutionCount count = board.counter->count(request.pegs);
+            response.countLow = static_cast<uint64_t>(count);
+            response.countHigh = static_cast<uint64_t>(count >> 64);
+            break;
+        }
+
+        case HINT_OP_HINT:
+        case HINT_OP_SOLVE: {
+            if (!oracle.solvable(request.pegs)) {
+                response.status = HINT_UNSOLVABLE;
+                break;
+            }
+            // Every step has a solvable child, and each check is a table hit
+            Bitboard pegs = request.pegs;
+            while (popCount(pegs) > 1 && response.jumps < HINT_MAX_JUMPS) {
+                int id = oracle.winningJump(pegs);
+                response.line[response.jumps++] = static_cast<uint8_t>(id);
+                pegs = applyJump(pegs, oracle.getShape().getJumps()[id]);
+                if (request.op == HINT_OP_HINT) break;
+            }
+            break;
+        }
+
+        default:
+            response.status = HINT_BAD_REQUEST;
+            break;
+    }
+}
+
+HintServer::Connection::~Connection() {
+    ::close(fd);
+}
+
+HintServer::HintServer(HintService& hintService, const std::string& socketPath, int workerThreads, size_t batch)
+    : service(hintService), path(socketPath), threads(std::max(workerThreads, 1)), batchSize(std::max(batch, size_t(1))),
+      listener(-1), stopping(false), requests(0), batches(0), deduplicated(0), connections(0) {
+}
+
+HintServer::~HintServer() {
+    if (listener >= 0) {
+        ::close(listener);
+        unlink(path.c_str());
+    }
+}
+
+bool HintServer::run() {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return false;
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    // A socket file left by an earlier run would make bind fail
+    unlink(path.c_str());
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, 128) != 0) {
+        std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    signalled = 0;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(std::thread(&HintServer::worker, this));
+    }
+
+    std::vector<std::shared_ptr<Connection> > open;
+    std::vector<pollfd> fds;
+    while (!stopping && !signalled) {
+        fds.clear();
+        pollfd entry = {listener, POLLIN, 0};
+        fds.push_back(entry);
+        for (const std::shared_ptr<Connection>& connection : open) {
+            entry.fd = connection->fd;
+            fds.push_back(entry);
+        }
+
+        // A timeout, so a stop request is noticed without any traffic
+        if (poll(fds.data(), fds.size(), 200) < 0 && errno != EINTR) {
+            std::cerr << "poll failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        // Connections first: accepting changes the list the poll results refer to.
+        // A connection that stops sending is only dropped from the poll; requests
+        // still queued hold it open until their responses are written.
+        size_t kept = 0;
+        for (size_t i = 0; i < open.size(); i++) {
+            if ((fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) && !readFrom(open[i])) {
+                continue;
+            }
+            open[kept++] = open[i];
+        }
+        open.resize(kept);
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                open.push_back(std::make_shared<Connection>(fd));
+                connections++;
+            }
+        }
+    }
+
+    stopping = true;
+    queueReady.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    return true;
+}
+
+bool HintServer::readFrom(const std::shared_ptr<Connection>& connection) {
+    uint8_t buffer[1 << 16];
+    ssize_t received = recv(connection->fd, buffer, sizeof(buffer), 0);
+    if (received < 0) {
+        if (errno == EINTR || errno == EAGAIN) {
+            return true;
+        }
+        connection->closed = true;
+        return false;
+    }
+    if (received == 0) {
+        // End of input: a client that only shut down its writing side still
+        // reads the answers to everything it sent
+        return false;
+    }
+
+    std::vector<uint8_t>& input = connection->input;
+    input.insert(input.end(), buffer, buffer + received);
+    size_t complete = input.size() / sizeof(HintRequest);
+    if (complete == 0) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(queueLock);
+        for (size_t i = 0; i < complete; i++) {
+            Pending pending;
+            pending.connection = connection;
+            std::memcpy(&pending.request, input.data() + i * sizeof(HintRequest), sizeof(HintRequest));
+            queue.push_back(pending);
+        }
+    }
+    input.erase(input.begin(), input.begin() + complete * sizeof(HintRequest));
+    queueReady.notify_all();
+    return true;
+}
+
+void HintServer::worker() {
+    std::vector<Pending> batch;
+    std::vector<HintResponse> responses;
+    batch.reserve(batchSize);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard(queueLock);
+            queueReady.wait(guard, [this]() { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            // Take whatever has queued up, to a limit, in one go
+            while (!queue.empty() && batch.size() < batchSize) {
+                batch.push_back(queue.front());
+                queue.pop_front();
+            }
+        }
+        process(batch, responses);
+        batch.clear();
+    }
+}
+
+void HintServer::process(std::vector<Pending>& batch, std::vector<HintResponse>& responses) {
+    responses.resize(batch.size());
+    for (size_t i = 0; i < batch.size(); i++) {
+        // Front ends often ask about the same position at once: answer it once
+        const HintRequest& request = batch[i].request;
+        size_t same = 0;
+        while (same < i && (batch[same].request.op != request.op || batch[same].request.shape != request.shape ||
+                            batch[same].request.pegs != request.pegs)) {
+            same++;
+        }
+        if (same < i) {
+            responses[i] = responses[same];
+            responses[i].id = request.id;
+            deduplicated++;
+        } else {
+            service.answer(request, responses[i]);
+        }
+    }
+    requests += batch.size();
+    batches++;
+
+    // One send per connection, with all of its responses from this batch
+    std::vector<uint8_t> output;
+    for (size_t i = 0; i < batch.size(); i++) {
+        // Held until the send is done: resetting the batch entries below may
+        // drop the last other reference, which would close the socket
+        std::shared_ptr<Connection> connection = batch[i].connection;
+        if (!connection) continue;
+
+        output.clear();
+        for (size_t j = i; j < batch.size(); j++) {
+            if (batch[j].connection != connection) continue;
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&responses[j]);
+            output.insert(output.end(), bytes, bytes + HINT_RESPONSE_HEADER + responses[j].jumps);
+            batch[j].connection.reset();
+        }
+
+        std::lock_guard<std::mutex> guard(connection->writeLock);
+        for (size_t sent = 0; sent < output.size() && !connection->closed;) {
+            ssize_t written = send(connection->fd, output.data() + sent, output.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0) {
+                if (written < 0 && errno == EINTR) continue;
+                connection->closed = true;   // Gone: later responses are not even tried
+                break;
+            }
+            sent += written;
+        }
+    }
+}
+
+HintServerStats HintServer::getStats() const {
+    HintServerStats stats;
+    stats.requests = requests.load();
+    stats.batches = batches.load();
+    stats.deduplicated = deduplicated.load();
+    stats.connections = connections.load();
+    return stats;
+}
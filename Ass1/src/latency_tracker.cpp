@@ -0,0 +1,121 @@
+#include "latency_tracker.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+LatencyTracker::LatencyTracker() {
+    clear();
+}
+
+void LatencyTracker::clear() {
+    started = Clock::now();
+    for (int i = 0; i < MARK_COUNT; i++) marks[i] = started;
+    pending.clear();
+    samples.clear();
+    std::fill(histogram, histogram + LATENCY_HISTOGRAM_BINS, 0.0f);
+    std::fill(stageSum, stageSum + STAGE_COUNT, 0.0);
+    std::fill(stageMax, stageMax + STAGE_COUNT, 0.0f);
+}
+
+float LatencyTracker::milliseconds(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<float, std::milli>(to - from).count();
+}
+
+void LatencyTracker::inputReceived(const char* source) {
+    PendingInput input;
+    input.source = source;
+    // Callbacks run inside glfwPollEvents, so this is still the previous frame's poll
+    input.lastPoll = marks[MARK_POLL_END];
+    input.received = input.handled = Clock::now();
+    input.changedState = false;
+    pending.push_back(input);
+}
+
+void LatencyTracker::inputHandled(bool changedState) {
+    if (pending.empty()) return;
+    pending.back().handled = Clock::now();
+    pending.back().changedState = changedState;
+}
+
+void LatencyTracker::mark(FrameMark mark) {
+    marks[mark] = Clock::now();
+}
+
+void LatencyTracker::endFrame(bool waitedForGpu) {
+    if (pending.empty()) return;
+    Clock::time_point end = waitedForGpu ? Clock::now() : marks[MARK_SWAP_END];
+
+    for (const PendingInput& input : pending) {
+        LatencySample sample;
+        sample.inputSeconds = std::chrono::duration<double>(input.received - started).count();
+        sample.source = input.source;
+        sample.changedState = input.changedState;
+        sample.stages[STAGE_POLLING] = milliseconds(input.lastPoll, input.received);
+        sample.stages[STAGE_LOGIC] = milliseconds(input.received, input.handled);
+        sample.stages[STAGE_QUEUED] = milliseconds(input.handled, marks[MARK_RENDER_START]);
+        sample.stages[STAGE_RENDER] = milliseconds(marks[MARK_RENDER_START], marks[MARK_RENDER_END]);
+        sample.stages[STAGE_UI] = milliseconds(marks[MARK_RENDER_END], marks[MARK_SWAP_START]);
+        sample.stages[STAGE_SWAP] = milliseconds(marks[MARK_SWAP_START], marks[MARK_SWAP_END]);
+        sample.stages[STAGE_GPU] = milliseconds(marks[MARK_SWAP_END], end);
+        sample.total = milliseconds(input.received, end);
+
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            stageSum[i] += sample.stages[i];
+            stageMax[i] = std::max(stageMax[i], sample.stages[i]);
+        }
+        int bin = static_cast<int>(sample.total / LATENCY_BIN_MILLISECONDS);
+        histogram[std::max(0, std::min(LATENCY_HISTOGRAM_BINS - 1, bin))] += 1.0f;
+        samples.push_back(sample);
+    }
+    pending.clear();
+}
+
+float LatencyTracker::getStageMean(LatencyStage stage) const {
+    return samples.empty() ? 0.0f : static_cast<float>(stageSum[stage] / samples.size());
+}
+
+float LatencyTracker::getTotalPercentile(float fraction) const {
+    if (samples.empty()) return 0.0f;
+    float wanted = fraction * samples.size();
+    float seen = 0.0f;
+    for (int i = 0; i < LATENCY_HISTOGRAM_BINS; i++) {
+        seen += histogram[i];
+        if (seen >= wanted) return (i + 1) * LATENCY_BIN_MILLISECONDS;
+    }
+    return LATENCY_HISTOGRAM_BINS * LATENCY_BIN_MILLISECONDS;
+}
+
+const char* LatencyTracker::stageName(LatencyStage stage) {
+    switch (stage) {
+        case STAGE_POLLING: return "polling";
+        case STAGE_LOGIC: return "logic";
+        case STAGE_QUEUED: return "queued";
+        case STAGE_RENDER: return "render";
+        case STAGE_UI: return "ui";
+        case STAGE_SWAP: return "swap";
+        case STAGE_GPU: return "gpu";
+        default: return "?";
+    }
+}
+
+bool LatencyTracker::writeCsv(const std::string& path) const {
+    std::ofstream out(path.c_str());
+    if (!out.is_open()) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    out << "input_seconds,source,changed_state";
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        out << "," << stageName(static_cast<LatencyStage>(i)) << "_ms";
+    }
+    out << ",total_ms\n";
+    for (const LatencySample& sample : samples) {
+        out << sample.inputSeconds << "," << sample.source << "," << (sample.changedState ? 1 : 0);
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            out << "," << sample.stages[i];
+        }
+        out << "," << sample.total << "\n";
+    }
+    return out.good();
+}
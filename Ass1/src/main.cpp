@@ -5,11 +5,24 @@
 #include <../external/imgui/imgui.h>
 #include <../external/imgui/backends/imgui_impl_glfw.h>
 #include <../external/imgui/backends/imgui_impl_opengl3.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <unistd.h>
 
+#include "../include/animator.h"
+#include "../include/anytime_solver.h"
 #include "../include/game.h"
+#include "../include/game_record.h"
+#include "../include/hint_client.h"
+#include "../include/latency_tracker.h"
+#include "../include/mcts.h"
+#include "../include/move_evaluator.h"
+#include "../include/opening_book.h"
 #include "../include/renderer.h"
+#include "../include/spectator_wall.h"
 #include "../include/theme.h"  // Add theme header
 
 
@@ -18,10 +31,54 @@ const char *WINDOW_TITLE = "Marble Solitaire";
 const int WINDOW_WIDTH = 800;
 const int WINDOW_HEIGHT = 800;
 
+// Search time per frame for hints, small enough to keep 60 fps
+const int HINT_BUDGET_MICROSECONDS = 2000;
+
+// Boards wider than this start on the textured, single-pass board renderer
+const int TEXTURE_BOARD_MIN_SIZE = 16;
+const int MAX_BOARD_SIZE = 256;
+
+// Where hints come from; 'M' cycles through them
+enum HintSource {
+    HINTS_SOLVER,
+    HINTS_MCTS,
+    HINTS_SERVICE   // A running `solitaire_tool serve`
+};
+
 // Global objects
 MarbleSolitaire *game = nullptr;
 Renderer *renderer = nullptr;
+Animator *animator = nullptr;
 GLFWwindow *window = nullptr;
+BoardShape hintShape = BoardShape::english();
+AnytimeSolver *hintSolver = nullptr;
+MctsPlayer *hintPlayer = nullptr;
+HintClient *hintClient = nullptr;
+OpeningBook *openingBook = nullptr;
+MoveEvaluator *moveEvaluator = nullptr;
+SpectatorWall *spectatorWall = nullptr;   // Only with --wall
+LatencyTracker *latencyTracker = nullptr; // Only when playing, not on the wall
+bool latencyWaitForGpu = false;           // Fence after each swap, so frames end when the GPU is done
+bool overlayEnabled = false;
+std::vector<MoveEvaluation> moveEvaluations;
+bool hintsEnabled = false;
+HintSource hintSource = HINTS_SOLVER;
+// Themes from assets/themes (or SOLITAIRE_THEMES), the built-in presets without it
+std::vector<Theme> themes;
+
+// The last question sent to the hint service, and its answer once it arrives
+Bitboard serviceAsked = 0;
+uint32_t serviceRequestId = 0;
+bool serviceAnswered = false;
+HintResponse serviceAnswer;
+
+// What the command line asks for
+struct LaunchOptions {
+    bool wallMode = false;
+    WallConfig wall;
+    RenderQuality quality = QUALITY_FULL;
+    float renderScale = 1.0f;
+};
 
 // Function prototypes
 void framebuffer_size_callback(GLFWwindow *window, int width, int height);
@@ -30,11 +87,27 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 void initializeGLFW();
 void initializeImGui();
 void mainLoop();
+void wallLoop();
+bool parseArguments(int argc, char **argv, LaunchOptions &options);
 void cleanup();
 void applyTheme(const Theme& theme);
-
-int main()
+void loadThemes();
+void themeWindow();
+void latencyWindow();
+std::string latencyLogPath();
+void waitForGpu();
+void updateHints();
+void updateMoveOverlay();
+void updateServiceHint(Bitboard pegs);
+std::string hintSocketPath();
+
+int main(int argc, char **argv)
 {
+    LaunchOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
     // Initialize GLFW and create window
     initializeGLFW();
     if (!window)
@@ -45,16 +118,59 @@ int main()
     // Initialize ImGui
     initializeImGui();
 
-    // Initialize game and renderer
-    game = new MarbleSolitaire(7);
+    // Initialize game and renderer; SOLITAIRE_BOARD_SIZE picks a bigger cross
+    int boardSize = 7;
+    const char *sizeText = std::getenv("SOLITAIRE_BOARD_SIZE");
+    if (sizeText) {
+        boardSize = std::max(5, std::min(MAX_BOARD_SIZE, std::atoi(sizeText)));
+    }
+    game = new MarbleSolitaire(boardSize);
     game->startTimer();
 
     renderer = new Renderer(WINDOW_WIDTH, WINDOW_HEIGHT);
     renderer->init();
+    if (boardSize >= TEXTURE_BOARD_MIN_SIZE) {
+        renderer->setBoardRenderMode(BOARD_TEXTURE);
+    }
+    renderer->setRenderQuality(options.quality, options.renderScale);
+    loadThemes();
+
+    // Jumps, undos and redos play out over a few frames instead of at once
+    animator = new Animator();
+    game->setRecordMoveEvents(true);
+    renderer->setAnimator(animator);
+
+    hintSolver = new AnytimeSolver(hintShape);
+    hintPlayer = new MctsPlayer(hintShape, MctsConfig());
+    hintClient = new HintClient();
+
+    // Optional: built with `solitaire_tool book-build assets/opening_book.bin`.
+    // The default is only opened when it is there; a SOLITAIRE_BOOK that
+    // cannot be read is reported.
+    const char *bookPath = std::getenv("SOLITAIRE_BOOK");
+    if (bookPath || access("assets/opening_book.bin", F_OK) == 0) {
+        openingBook = new OpeningBook(bookPath ? bookPath : "assets/opening_book.bin");
+        if (!openingBook->isOpen() || openingBook->getShape().getName() != hintShape.getName()) {
+            delete openingBook;
+            openingBook = nullptr;
+        }
+    }
 
-    // Main game loop
-    mainLoop();
-    applyTheme(Theme::classicWood());
+    moveEvaluator = new MoveEvaluator(hintShape);
+    moveEvaluator->setBook(openingBook);
+
+    // Main game loop, or the spectator wall instead of a game
+    if (options.wallMode) {
+        spectatorWall = new SpectatorWall(hintShape, hintShape.startPosition(), options.wall);
+        spectatorWall->start();
+        wallLoop();
+    } else {
+        latencyTracker = new LatencyTracker();
+        mainLoop();
+        if (std::getenv("SOLITAIRE_LATENCY_LOG")) {
+            latencyTracker->writeCsv(latencyLogPath());
+        }
+    }
 
     // Cleanup
     cleanup();
@@ -62,16 +178,84 @@ int main()
     return 0;
 }
 
-// Apply a theme to both renderer and global settings
+// `--wall N` watches N self-play games instead of playing one; `--low-cost`
+// picks the render tier for machines without a GPU
+bool parseArguments(int argc, char **argv, LaunchOptions &options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--wall" && hasValue) {
+            options.wallMode = true;
+            options.wall.boards = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--wall-policy" && hasValue) {
+            SimulationPolicy& policy = options.wall.policy;
+            if (!parsePolicy(argv[++i], policy) || (policy != POLICY_RANDOM && policy != POLICY_GREEDY_MOBILITY)) {
+                std::cerr << "The wall plays random or greedy games" << std::endl;
+                return false;
+            }
+        } else if (arg == "--wall-threads" && hasValue) {
+            options.wall.threads = std::atoi(argv[++i]);
+        } else if (arg == "--wall-tick-ms" && hasValue) {
+            options.wall.tickMilliseconds = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--low-cost") {
+            options.quality = QUALITY_LOW_COST;
+        } else if (arg == "--render-scale" && hasValue) {
+            options.renderScale = static_cast<float>(std::atof(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--wall N] [--wall-policy random|greedy] [--wall-threads N] [--wall-tick-ms N]"
+                      << " [--low-cost] [--render-scale 0.25-1]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// The renderer keeps the global theme and its uniform buffer in step
 void applyTheme(const Theme& theme) {
-    // Set the theme in the renderer
     renderer->setTheme(theme);
+    std::cout << "Theme applied: " << theme.NAME << std::endl;
+}
 
-    // Also update any global theme settings
-    currentTheme = theme;
+void loadThemes()
+{
+    const char *directory = std::getenv("SOLITAIRE_THEMES");
+    themes = Theme::loadDirectory(directory ? directory : "assets/themes");
+    if (themes.empty()) {
+        themes.push_back(Theme::classicWood());
+        themes.push_back(Theme::modern());
+        themes.push_back(Theme::royal());
+    }
+}
 
-    std::cout << "Theme applied: " << (theme.MARBLE_COLOR.r > 0.5f ? "Classic Wood" :
-                                     (theme.MARBLE_COLOR.g > 0.5f ? "Modern" : "Royal")) << std::endl;
+// One button per theme; collapsed, ImGui skips its contents altogether
+void themeWindow()
+{
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Theme Settings")) {
+        for (size_t i = 0; i < themes.size(); i++) {
+            const Theme& theme = themes[i];
+            ImGui::PushID(static_cast<int>(i));
+            if (ImGui::Button(theme.NAME.c_str())) {
+                applyTheme(theme);
+            }
+            ImGui::PopID();
+            ImGui::SameLine();
+            const glm::vec4& color = theme.MARBLE_COLOR;
+            ImGui::TextColored(ImVec4(color.r, color.g, color.b, 1.0f), "%s", theme.DESCRIPTION.c_str());
+        }
+
+        // Theme files can be edited while the game runs
+        if (ImGui::Button("Reload theme files")) {
+            std::string current = currentTheme.NAME;
+            loadThemes();
+            for (const Theme& theme : themes) {
+                if (theme.NAME == current) applyTheme(theme);
+            }
+        }
+    }
+    ImGui::End();
 }
 
 void initializeGLFW()
@@ -135,19 +319,118 @@ void initializeImGui()
 void mainLoop()
 {
     game->startTimer();
+    double lastFrame = glfwGetTime();
     while (!glfwWindowShouldClose(window))
     {
         // Poll and handle events
         glfwPollEvents();
+        latencyTracker->mark(MARK_POLL_END);
+
+        // Moves made by this frame's input become animations, stepped at a fixed rate
+        double frameTime = glfwGetTime();
+        animator->consume(*game);
+        animator->advance(frameTime - lastFrame);
+        lastFrame = frameTime;
 
         // Start the ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        // Clear the framebuffer
-         // Clear the framebuffer with theme background color
-         glClearColor(
+        // Render game; it clears the framebuffer itself, at most once per frame
+        latencyTracker->mark(MARK_RENDER_START);
+        renderer->renderGame(*game);
+        latencyTracker->mark(MARK_RENDER_END);
+
+        // Give the hint search its slice of the frame
+        updateHints();
+        updateMoveOverlay();
+
+        // Create ImGui interface
+        renderer->renderUI(*game);
+
+        themeWindow();
+        latencyWindow();
+
+        // Render ImGui
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+        // Swap buffers; the frame closes the latency of every input handled since the last one
+        latencyTracker->mark(MARK_SWAP_START);
+        glfwSwapBuffers(window);
+        latencyTracker->mark(MARK_SWAP_END);
+        if (latencyWaitForGpu) {
+            waitForGpu();
+        }
+        latencyTracker->endFrame(latencyWaitForGpu);
+    }
+}
+
+// Blocks until the GPU has run everything up to the swap, so the latency
+// includes the frame actually reaching the screen rather than being queued
+void waitForGpu()
+{
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);   // 100 ms
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, 0, 100000000);
+    }
+    glDeleteSync(fence);
+}
+
+std::string latencyLogPath()
+{
+    const char *path = std::getenv("SOLITAIRE_LATENCY_LOG");
+    return path ? path : "latency.csv";
+}
+
+// Input-to-photon latency: a histogram of totals and where the time goes
+void latencyWindow()
+{
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Latency")) {
+        size_t count = latencyTracker->getSamples().size();
+        ImGui::Text("%zu inputs, median %.0f ms, 95%% under %.0f ms", count,
+                    latencyTracker->getTotalPercentile(0.5f), latencyTracker->getTotalPercentile(0.95f));
+        ImGui::PlotHistogram("##latency", latencyTracker->getHistogram(), LATENCY_HISTOGRAM_BINS, 0,
+                             "callback to frame end, 1 ms bins", 0.0f, FLT_MAX, ImVec2(0, 80));
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            LatencyStage stage = static_cast<LatencyStage>(i);
+            ImGui::Text("%-8s mean %6.2f ms  max %6.2f ms", LatencyTracker::stageName(stage),
+                        latencyTracker->getStageMean(stage), latencyTracker->getStageMax(stage));
+        }
+
+        ImGui::Checkbox("Wait for the GPU after each swap", &latencyWaitForGpu);
+        if (ImGui::Button("Export")) {
+            std::string path = latencyLogPath();
+            if (latencyTracker->writeCsv(path)) {
+                std::cout << "Latency written to " << path << std::endl;
+            }
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Clear")) {
+            latencyTracker->clear();
+        }
+    }
+    ImGui::End();
+}
+
+// Every board of the spectator wall from the newest snapshot, in one draw
+// call however many boards there are
+void wallLoop()
+{
+    std::vector<WallBoard> boards;
+    uint64_t sequence = 0;
+    while (!glfwWindowShouldClose(window))
+    {
+        glfwPollEvents();
+
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+
+        glClearColor(
             currentTheme.BACKGROUND_COLOR.r,
             currentTheme.BACKGROUND_COLOR.g,
             currentTheme.BACKGROUND_COLOR.b,
@@ -155,43 +438,178 @@ void mainLoop()
         );
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        bool changed = spectatorWall->latest(boards, sequence);
+        renderer->renderWall(spectatorWall->getShape(), boards, changed);
 
-        // Render game
-        renderer->renderGame(*game);
+        WallStats stats = spectatorWall->getStats();
+        ImGui::Begin("Wall");
+        ImGui::Text("%d boards on %d threads", spectatorWall->getBoards(), spectatorWall->getThreads());
+        ImGui::Text("%llu ticks, %llu games, %llu won", static_cast<unsigned long long>(stats.ticks),
+                    static_cast<unsigned long long>(stats.games), static_cast<unsigned long long>(stats.wins));
+        ImGui::Text("%.1f fps", ImGui::GetIO().Framerate);
+        ImGui::End();
 
-        // Create ImGui interface
-        renderer->renderUI(*game);
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+        glfwSwapBuffers(window);
+    }
+}
 
-        // Add theme selector to ImGui
-        ImGui::Begin("Theme Settings");
+// Restarts the hint search whenever the board changes, then searches for
+// one frame's budget. The hint improves over the following frames.
+void updateHints()
+{
+    // The hint engines only know the 7x7 English board
+    if (!hintsEnabled || game->getBoardSize() != hintShape.getSize()) {
+        return;
+    }
+
+    Bitboard pegs = hintShape.fromGame(*game);
 
-        if (ImGui::Button("Classic Wood Theme")) {
-            applyTheme(Theme::classicWood());
+    // Opening positions come straight from the book, with no search at all
+    OpeningBookHit bookHit;
+    if (hintSource != HINTS_SERVICE && openingBook && openingBook->lookup(pegs, bookHit)) {
+        if (bookHit.bestJump >= 0) {
+            renderer->renderHint(*game, hintShape.toMove(bookHit.bestJump));
         }
-        ImGui::SameLine();
-        ImGui::TextColored(ImVec4(0.76f, 0.6f, 0.42f, 1.0f), "Wood board with blue marbles");
+        ImGui::Begin("Hint");
+        ImGui::Text(bookHit.solvable ? "Opening book: this position can still be won"
+                                     : "Opening book: no winning line from here");
+        if (bookHit.counted) {
+            ImGui::Text("%s winning jump sequences", formatCount(bookHit.solutions).c_str());
+        }
+        ImGui::End();
+        return;
+    }
 
-        if (ImGui::Button("Modern Theme")) {
-            applyTheme(Theme::modern());
+    if (hintSource == HINTS_SERVICE) {
+        updateServiceHint(pegs);
+        return;
+    }
+    if (hintSource == HINTS_MCTS) {
+        if (pegs != hintPlayer->getRoot()) {
+            hintPlayer->start(pegs);
         }
-        ImGui::SameLine();
-        ImGui::TextColored(ImVec4(0.18f, 0.8f, 0.7f, 1.0f), "Gray board with teal marbles");
+        hintPlayer->step(0, HINT_BUDGET_MICROSECONDS);
 
-        if (ImGui::Button("Royal Theme")) {
-            applyTheme(Theme::royal());
+        MctsResult result = hintPlayer->getResult();
+        if (result.bestJump >= 0) {
+            renderer->renderHint(*game, hintShape.toMove(result.bestJump));
         }
-        ImGui::SameLine();
-        ImGui::TextColored(ImVec4(0.9f, 0.75f, 0.1f, 1.0f), "Purple board with gold marbles");
 
+        ImGui::Begin("Hint");
+        ImGui::Text("Tree search: %llu rollouts (%.0f per second)", static_cast<unsigned long long>(result.rollouts),
+                    result.rolloutsPerSecond());
+        ImGui::Text("Best jump: %llu visits, mean reward %.3f", static_cast<unsigned long long>(result.bestJumpVisits),
+                    result.bestJumpValue);
+        ImGui::Text("Best rollout leaves %d marbles", result.bestRolloutPegs);
         ImGui::End();
+        return;
+    }
 
-        // Render ImGui
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    if (hintSolver->getStatus() == ANYTIME_IDLE || pegs != hintSolver->getStart()) {
+        hintSolver->start(pegs);
+    }
+    AnytimeStatus status = hintSolver->step(0, HINT_BUDGET_MICROSECONDS);
 
-        // Swap buffers
-        glfwSwapBuffers(window);
+    Move hint;
+    if (hintSolver->getHint(hint)) {
+        renderer->renderHint(*game, hint);
+    }
+
+    ImGui::Begin("Hint");
+    if (status == ANYTIME_SOLVED) {
+        ImGui::Text("Solution found");
+    } else if (status == ANYTIME_EXHAUSTED) {
+        ImGui::Text("No solution, best line leaves %d marbles", hintSolver->getBestPegs());
+    } else {
+        ImGui::Text("Searching... best line leaves %d marbles", hintSolver->getBestPegs());
     }
+    ImGui::Text("%llu positions searched", static_cast<unsigned long long>(hintSolver->getNodes()));
+    ImGui::End();
+}
+
+// Starts evaluating every legal move whenever the board changes, and draws
+// whatever verdicts the worker threads have delivered so far
+void updateMoveOverlay()
+{
+    if (!overlayEnabled || game->getBoardSize() != hintShape.getSize()) {
+        return;
+    }
+
+    Bitboard pegs = hintShape.fromGame(*game);
+    if (pegs != moveEvaluator->getPosition()) {
+        moveEvaluator->evaluate(pegs);
+    }
+    bool complete = moveEvaluator->getResults(moveEvaluations);
+    renderer->renderMoveOverlay(*game, hintShape, moveEvaluations);
+
+    int winnable = 0, dead = 0;
+    for (const MoveEvaluation& evaluation : moveEvaluations) {
+        winnable += evaluation.quality == MOVE_WINNABLE;
+        dead += evaluation.quality == MOVE_DEAD;
+    }
+    ImGui::Begin("Moves");
+    ImGui::Text("%d winnable, %d dead, %d of %d evaluated", winnable, dead, winnable + dead,
+                static_cast<int>(moveEvaluations.size()));
+    ImGui::Text(complete ? "Done in %.1f ms on %d threads" : "Evaluating... %.1f ms on %d threads",
+                moveEvaluator->getSeconds() * 1000.0, moveEvaluator->getThreads());
+    ImGui::End();
+}
+
+std::string hintSocketPath()
+{
+    const char *path = std::getenv("SOLITAIRE_HINT_SOCKET");
+    return path ? path : HINT_DEFAULT_SOCKET;
+}
+
+// Asks the hint service once per board and checks for its answer every
+// frame without waiting, so a slow or busy service never costs a frame.
+void updateServiceHint(Bitboard pegs)
+{
+    ImGui::Begin("Hint");
+    if (!hintClient->isConnected()) {
+        ImGui::Text("No hint service at %s", hintSocketPath().c_str());
+        ImGui::Text("Start one with: solitaire_tool serve, then press M");
+        ImGui::End();
+        return;
+    }
+
+    uint8_t shapeId = RECORD_ENGLISH;
+    recordShapeFor(hintShape, shapeId);
+    if (pegs != serviceAsked) {
+        HintRequest request;
+        request.id = ++serviceRequestId;
+        request.op = HINT_OP_HINT;
+        request.shape = shapeId;
+        request.reserved = 0;
+        request.pegs = pegs;
+        hintClient->send(request);
+        serviceAsked = pegs;
+        serviceAnswered = false;
+    }
+
+    // Answers to boards the player has already left are dropped
+    HintResponse response;
+    while (hintClient->poll(response)) {
+        if (response.id == serviceRequestId) {
+            serviceAnswer = response;
+            serviceAnswered = true;
+        }
+    }
+
+    if (!serviceAnswered) {
+        ImGui::Text("Waiting for the hint service...");
+    } else if (serviceAnswer.status == HINT_OK && serviceAnswer.jumps > 0) {
+        renderer->renderHint(*game, hintShape.toMove(serviceAnswer.line[0]));
+        ImGui::Text("Hint service: this position can still be won");
+    } else if (serviceAnswer.status == HINT_OK) {
+        ImGui::Text("Hint service: solved");
+    } else {
+        ImGui::Text("Hint service: no winning line from here");
+    }
+    ImGui::End();
 }
 
 void cleanup()
@@ -202,6 +620,14 @@ void cleanup()
     ImGui::DestroyContext();
 
     // Delete game and renderer
+    delete spectatorWall;
+    delete hintSolver;
+    delete hintPlayer;
+    delete hintClient;
+    delete moveEvaluator;   // Before the book its workers read from
+    delete openingBook;
+    delete animator;
+    delete latencyTracker;
     delete renderer;
     delete game;
 
@@ -224,7 +650,15 @@ void clearSelection() {
 
 // In your mouse_button_callback function, add a right-click handler to clear selection
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+    if (spectatorWall) {
+        return;   // Nothing to click on the wall
+    }
     if (action == GLFW_PRESS) {
+        if (button != GLFW_MOUSE_BUTTON_LEFT && button != GLFW_MOUSE_BUTTON_RIGHT) {
+            return;   // Other buttons do nothing, so they are not timed either
+        }
+        latencyTracker->inputReceived(button == GLFW_MOUSE_BUTTON_LEFT ? "click" : "right_click");
+
         // Get cursor position
         double xpos, ypos;
         glfwGetCursorPos(window, &xpos, &ypos);
@@ -251,13 +685,16 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 
         // Right-click to clear selection
         if (button == GLFW_MOUSE_BUTTON_RIGHT) {
+            bool hadSelection = game->getSelectedPosition().isValid();
             clearSelection();
+            latencyTracker->inputHandled(hadSelection);
             return;
         }
 
         // Left-click to make selection or move
         if (button == GLFW_MOUSE_BUTTON_LEFT) {
             bool stateChanged = game->processClick(row, col);
+            latencyTracker->inputHandled(stateChanged);
             if (!stateChanged) {
                 // If click was invalid, provide feedback
                 std::cout << "Invalid selection or move attempt at (" << row << "," << col << ")" << std::endl;
@@ -303,23 +740,55 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 // Add or update your key callback function
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (action == GLFW_PRESS) {
+        if (latencyTracker) {
+            latencyTracker->inputReceived("key");
+        }
+        // Only keys that touch the game change its state; the rest switch views or settings
+        bool stateChanged = false;
         switch (key) {
             case GLFW_KEY_ESCAPE:
                 glfwSetWindowShouldClose(window, true);
                 break;
             case GLFW_KEY_C:  // 'C' to clear selection
+                stateChanged = game->getSelectedPosition().isValid();
                 clearSelection();
                 break;
             case GLFW_KEY_U:  // 'U' to undo
-                game->undoMove();
+                stateChanged = game->undoMove();
                 break;
             case GLFW_KEY_R:  // 'R' to redo
-                game->redoMove();
+                stateChanged = game->redoMove();
                 break;
             case GLFW_KEY_N:  // 'N' for new game
                 game->reset();
                 game->startTimer();
+                stateChanged = true;
+                break;
+            case GLFW_KEY_H:  // 'H' to toggle hints
+                hintsEnabled = !hintsEnabled;
+                break;
+            case GLFW_KEY_T:  // 'T' to switch between per-cell and textured board rendering
+                renderer->setBoardRenderMode(renderer->getBoardRenderMode() == BOARD_TEXTURE ? BOARD_GEOMETRY
+                                                                                              : BOARD_TEXTURE);
                 break;
+            case GLFW_KEY_L:  // 'L' to switch to the low-cost tier for software rendering and back
+                renderer->setRenderQuality(renderer->getRenderQuality() == QUALITY_LOW_COST ? QUALITY_FULL
+                                                                                            : QUALITY_LOW_COST,
+                                           renderer->getRenderScale());
+                break;
+            case GLFW_KEY_O:  // 'O' to toggle the move quality overlay
+                overlayEnabled = !overlayEnabled;
+                break;
+            case GLFW_KEY_M:  // 'M' to cycle hints between the solver, tree search and the hint service
+                hintSource = static_cast<HintSource>((hintSource + 1) % 3);
+                if (hintSource == HINTS_SERVICE && !hintClient->isConnected()) {
+                    hintClient->connect(hintSocketPath());
+                }
+                serviceAsked = 0;
+                break;
+        }
+        if (latencyTracker) {
+            latencyTracker->inputHandled(stateChanged);
         }
     }
 }
\ No newline at end of file
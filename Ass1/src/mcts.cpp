@@ -0,0 +1,307 @@
+#include "mcts.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+MctsPlayer::MctsPlayer(const BoardShape& boardShape, const MctsConfig& mctsConfig)
+    : shape(boardShape), config(mctsConfig), root(0), rootPegs(0), activeTrees(0), carriedPegs(0) {
+    config.threads = std::max(config.threads, 1);
+    config.poolNodes = std::max(config.poolNodes, size_t(1));
+    trees.resize(config.threads);
+    for (Tree& tree : trees) {
+        tree.nodes.resize(config.poolNodes);
+        tree.bestLine.reserve(shape.getHoleCount());
+    }
+    carried.reserve(shape.getHoleCount());
+}
+
+const std::vector<int>* MctsPlayer::bestLine(int& pegs) const {
+    const std::vector<int>* line = nullptr;
+    pegs = rootPegs;
+    for (size_t t = 0; t < activeTrees; t++) {
+        if (!trees[t].bestLine.empty() && trees[t].bestPegs < pegs) {
+            pegs = trees[t].bestPegs;
+            line = &trees[t].bestLine;
+        }
+    }
+    return line;
+}
+
+void MctsPlayer::carryOver(Bitboard pegs) {
+    // When the game follows the first jump of the best line so far, the rest
+    // of it seeds the next search, so a result found once is never lost again
+    int left;
+    const std::vector<int>* line = bestLine(left);
+    carried.clear();
+    carriedPegs = popCount(pegs);
+    if (line && applyJump(root, shape.getJumps()[line->front()]) == pegs) {
+        carried.assign(line->begin() + 1, line->end());
+        carriedPegs = left;
+    }
+}
+
+void MctsPlayer::reset(Tree& tree, uint64_t seed) {
+    // The pool keeps its memory; only the root is live again
+    std::seed_seq seeds{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    tree.rng.seed(seeds);
+    tree.used = 1;
+    tree.rollouts = 0;
+    tree.bestPegs = carriedPegs;
+    tree.bestLine.assign(carried.begin(), carried.end());
+    tree.seconds = 0.0;
+
+    Node& node = tree.nodes[0];
+    node.pegs = root;
+    node.parent = -1;
+    node.firstChild = -1;
+    node.visits = 0;
+    node.childCount = 0;
+    node.jump = -1;
+    node.totalReward = 0.0;
+    node.bestReward = 0.0f;
+}
+
+void MctsPlayer::start(Bitboard pegs) {
+    carryOver(pegs);
+    root = pegs;
+    rootPegs = popCount(pegs);
+    reset(trees[0], config.seed);
+    activeTrees = 1;
+}
+
+void MctsPlayer::step(uint64_t iterations, int microseconds) {
+    if (activeTrees == 0) return;
+    grow(trees[0], iterations, microseconds);
+}
+
+MctsResult MctsPlayer::search(Bitboard pegs) {
+    carryOver(pegs);
+    root = pegs;
+    rootPegs = popCount(pegs);
+    activeTrees = trees.size();
+
+    int microseconds = config.milliseconds * 1000;
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < trees.size(); i++) {
+        // Every tree gets its own seed, so the trees explore differently
+        reset(trees[i], config.seed + 0x9E3779B97F4A7C15ULL * i);
+        uint64_t iterations = config.iterations / trees.size() + (i < config.iterations % trees.size() ? 1 : 0);
+        if (config.iterations && iterations == 0) continue;
+        workers.push_back(std::thread(&MctsPlayer::grow, this, std::ref(trees[i]), iterations, microseconds));
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    return getResult();
+}
+
+void MctsPlayer::grow(Tree& tree, uint64_t iterations, int microseconds) {
+    auto startTime = std::chrono::steady_clock::now();
+    auto deadline = startTime + std::chrono::microseconds(microseconds);
+
+    // Without any budget there would be no end
+    if (iterations == 0 && microseconds <= 0) {
+        iterations = 1000;
+    }
+
+    int line[64];
+    for (uint64_t i = 0; iterations == 0 || i < iterations; i++) {
+        if (microseconds > 0 && (i & 15) == 0 && std::chrono::steady_clock::now() >= deadline) break;
+        iterate(tree, line);
+    }
+    tree.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+bool MctsPlayer::expand(Tree& tree, int32_t index) {
+    const std::vector<Jump>& jumps = shape.getJumps();
+    Bitboard pegs = tree.nodes[index].pegs;
+
+    int count = 0;
+    for (size_t id = 0; id < jumps.size(); id++) {
+        count += canJump(pegs, jumps[id]);
+    }
+    if (tree.used + count > tree.nodes.size()) {
+        return false;   // Pool exhausted: this node keeps running plain rollouts
+    }
+
+    int32_t first = static_cast<int32_t>(tree.used);
+    for (size_t id = 0; id < jumps.size(); id++) {
+        if (!canJump(pegs, jumps[id])) continue;
+
+        Node& child = tree.nodes[tree.used++];
+        child.pegs = applyJump(pegs, jumps[id]);
+        child.parent = index;
+        child.firstChild = -1;
+        child.visits = 0;
+        child.childCount = 0;
+        child.jump = static_cast<int16_t>(id);
+        child.totalReward = 0.0;
+        child.bestReward = 0.0f;
+    }
+    tree.nodes[index].firstChild = first;
+    tree.nodes[index].childCount = static_cast<uint16_t>(count);
+    return true;
+}
+
+void MctsPlayer::iterate(Tree& tree, int* line) {
+    int length = 0;
+    int32_t current = 0;
+
+    // Selection: descend by UCT until reaching a node that was never visited
+    while (true) {
+        Node& node = tree.nodes[current];
+        if (node.firstChild < 0 && ((node.visits == 0 && current != 0) || !expand(tree, current))) break;
+        if (node.childCount == 0) break;
+
+        int32_t best = -1;
+        double bestScore = -1.0;
+        double logVisits = std::log(double(node.visits) + 1.0);
+        for (int32_t c = node.firstChild; c < node.firstChild + node.childCount; c++) {
+            const Node& child = tree.nodes[c];
+            if (child.visits == 0) {
+                best = c;
+                break;
+            }
+            double mean = child.totalReward / child.visits;
+            double score = mean + config.bestWeight * (child.bestReward - mean) + config.exploration * std::sqrt(logVisits / child.visits);
+            if (score > bestScore) {
+                bestScore = score;
+                best = c;
+            }
+        }
+        current = best;
+        line[length++] = tree.nodes[current].jump;
+        if (tree.nodes[current].visits == 0) break;
+    }
+
+    // Rollout: random jumps until none is left
+    const std::vector<Jump>& jumps = shape.getJumps();
+    Bitboard pegs = tree.nodes[current].pegs;
+    int legal[256];
+    while (true) {
+        int count = 0;
+        for (size_t id = 0; id < jumps.size() && count < 256; id++) {
+            if (canJump(pegs, jumps[id])) {
+                legal[count++] = static_cast<int>(id);
+            }
+        }
+        if (count == 0) break;
+
+        int id = legal[std::uniform_int_distribution<int>(0, count - 1)(tree.rng)];
+        pegs = applyJump(pegs, jumps[id]);
+        if (length < 64) line[length++] = id;
+    }
+    tree.rollouts++;
+
+    int left = popCount(pegs);
+    if (left < tree.bestPegs) {
+        tree.bestPegs = left;
+        tree.bestLine.assign(line, line + length);
+    }
+
+    // Backpropagation
+    double reward = rootPegs > 1 ? double(rootPegs - left) / (rootPegs - 1) : 1.0;
+    for (int32_t index = current; index >= 0; index = tree.nodes[index].parent) {
+        tree.nodes[index].visits++;
+        tree.nodes[index].totalReward += reward;
+        tree.nodes[index].bestReward = std::max(tree.nodes[index].bestReward, float(reward));
+    }
+}
+
+int MctsPlayer::getBestJump() const {
+    // A line that reached fewer marbles beats any average; the most visited
+    // jump only decides before any rollout finished. Never allocates.
+    int left;
+    const std::vector<int>* line = bestLine(left);
+    if (line) {
+        return line->front();
+    }
+
+    int best = -1;
+    uint64_t bestVisits = 0;
+    for (size_t t = 0; t < activeTrees; t++) {
+        const Node& top = trees[t].nodes[0];
+        for (int32_t c = top.firstChild; top.firstChild >= 0 && c < top.firstChild + top.childCount; c++) {
+            int jump = trees[t].nodes[c].jump;
+            uint64_t visits = 0;
+            for (size_t u = 0; u < activeTrees; u++) {
+                const Node& other = trees[u].nodes[0];
+                for (int32_t d = other.firstChild; other.firstChild >= 0 && d < other.firstChild + other.childCount; d++) {
+                    visits += trees[u].nodes[d].jump == jump ? trees[u].nodes[d].visits : 0;
+                }
+            }
+            if (visits > bestVisits || (visits == bestVisits && visits > 0 && jump < best)) {
+                bestVisits = visits;
+                best = jump;
+            }
+        }
+    }
+    return best;
+}
+
+MctsResult MctsPlayer::getResult() const {
+    MctsResult result;
+    result.bestRolloutPegs = rootPegs;
+    if (activeTrees == 0) {
+        return result;
+    }
+
+    // Root statistics per jump id, summed over the trees
+    std::vector<uint64_t> visits(shape.getJumps().size(), 0);
+    std::vector<double> rewards(shape.getJumps().size(), 0.0);
+    size_t bestTree = 0;
+    for (size_t t = 0; t < activeTrees; t++) {
+        const Tree& tree = trees[t];
+        const Node& top = tree.nodes[0];
+        for (int32_t c = top.firstChild; top.firstChild >= 0 && c < top.firstChild + top.childCount; c++) {
+            visits[tree.nodes[c].jump] += tree.nodes[c].visits;
+            rewards[tree.nodes[c].jump] += tree.nodes[c].totalReward;
+        }
+
+        result.rollouts += tree.rollouts;
+        result.nodes += tree.used;
+        result.seconds = std::max(result.seconds, tree.seconds);
+        if (tree.bestPegs < result.bestRolloutPegs) {
+            result.bestRolloutPegs = tree.bestPegs;
+            result.bestRollout = tree.bestLine;
+        }
+    }
+
+    result.bestJump = getBestJump();
+    if (result.bestJump >= 0 && visits[result.bestJump] > 0) {
+        result.bestJumpVisits = visits[result.bestJump];
+        result.bestJumpValue = rewards[result.bestJump] / visits[result.bestJump];
+    }
+
+    // Principal line from the tree that spent the most visits on the chosen jump
+    uint32_t mostVisits = 0;
+    for (size_t t = 0; t < activeTrees; t++) {
+        const Node& top = trees[t].nodes[0];
+        for (int32_t c = top.firstChild; top.firstChild >= 0 && c < top.firstChild + top.childCount; c++) {
+            if (trees[t].nodes[c].jump == result.bestJump && trees[t].nodes[c].visits > mostVisits) {
+                mostVisits = trees[t].nodes[c].visits;
+                bestTree = t;
+            }
+        }
+    }
+    const Tree& tree = trees[bestTree];
+    int32_t current = 0;
+    while (tree.nodes[current].firstChild >= 0 && tree.nodes[current].childCount > 0) {
+        const Node& node = tree.nodes[current];
+        int32_t next = -1;
+        uint32_t nextVisits = 0;
+        for (int32_t c = node.firstChild; c < node.firstChild + node.childCount; c++) {
+            bool forced = current == 0 && tree.nodes[c].jump == result.bestJump;
+            if (forced || (current != 0 && tree.nodes[c].visits > nextVisits)) {
+                next = c;
+                nextVisits = tree.nodes[c].visits;
+                if (forced) break;
+            }
+        }
+        if (next < 0 || tree.nodes[next].visits == 0) break;
+        result.principalLine.push_back(tree.nodes[next].jump);
+        current = next;
+    }
+    return result;
+}
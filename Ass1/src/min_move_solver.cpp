@@ -0,0 +1,210 @@
+#include "min_move_solver.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+// Depth-first search for the chain of jumps by one marble that turns
+// `pegs` into `target`, appending visited holes to `chain`
+bool traceChain(const BoardShape& shape, Bitboard pegs, int hole, Bitboard target, std::vector<int>& chain) {
+    if (pegs == target) {
+        return true;
+    }
+    for (int id : shape.jumpsFrom(hole)) {
+        const Jump& jump = shape.getJumps()[id];
+        if (!canJump(pegs, jump)) continue;
+
+        chain.push_back(jump.to);
+        if (traceChain(shape, applyJump(pegs, jump), jump.to, target, chain)) {
+            return true;
+        }
+        chain.pop_back();
+    }
+    return false;
+}
+
+} // namespace
+
+MinMoveSolver::MinMoveSolver(const BoardShape& boardShape, size_t tableMegabytes,
+                             ReplacementPolicy policy, bool hugePages)
+    : shape(boardShape), table(tableMegabytes, policy, hugePages), goalMask(boardShape.getHoles()),
+      symmetryMask(BoardShape::ALL_SYMMETRIES), nodes(0), verbose(false), overflow(false),
+      arena(MAX_CHILDREN * sizeof(Child) + 4096) {
+}
+
+bool MinMoveSolver::isGoal(Bitboard pegs) const {
+    return popCount(pegs) == 1 && (pegs & goalMask);
+}
+
+int MinMoveSolver::lowerBound(Bitboard pegs) const {
+    if (popCount(pegs) == 1) {
+        return isGoal(pegs) ? 0 : 1000;
+    }
+
+    // Every marble sitting in a corner has to start a move of its own,
+    // except one that may simply stay put as the final marble
+    Bitboard stuck = pegs & shape.getCorners();
+    int bound = popCount(stuck);
+    if (stuck & goalMask) {
+        bound--;
+    }
+    return std::max(bound, 1);
+}
+
+MinMoveResult MinMoveSolver::solve(Bitboard start, int goalHole, int maxMoves) {
+    MinMoveResult result;
+    goalMask = goalHole < 0 ? shape.getHoles() : (Bitboard(1) << goalHole);
+
+    // Positions can only be merged under symmetries that keep the goal in place
+    symmetryMask = shape.stabilizer(goalMask);
+    table.clear();
+    nodes = 0;
+
+    overflow = false;
+
+    // Everything the search touches per node is carved out of the arena here
+    arena.reset();
+    if (!path.attach(arena, maxMoves + 1) || !children.attach(arena, MAX_CHILDREN)) {
+        std::cerr << "Search arena too small for " << maxMoves << " moves" << std::endl;
+        return result;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    uint64_t allocationsBefore = heapAllocationCount();
+    bool found = false;
+    for (int bound = lowerBound(start); bound <= maxMoves && !found; bound++) {
+        // Budgets failed under smaller bounds stay, but give way first
+        table.newSearch();
+        path.clear();
+        path.push(start);
+        children.clear();
+        found = search(BoardState::from(start), bound);
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (verbose) {
+            std::cout << "Bound " << bound << ": " << nodes << " nodes, " << elapsed << " s, "
+                      << static_cast<uint64_t>(elapsed > 0.0 ? nodes / elapsed : 0.0) << " nodes/s" << std::endl;
+        }
+
+        if (found) {
+            result.solved = true;
+            result.moves = bound;
+        }
+    }
+    result.searchAllocations = heapAllocationCount() - allocationsBefore;
+
+    if (overflow) {
+        std::cerr << "Move stack overflow, some moves were not searched" << std::endl;
+    }
+    for (size_t i = 0; result.solved && i + 1 < path.size(); i++) {
+        result.line.push_back(findChain(path[i], path[i + 1]));
+    }
+
+    result.nodes = nodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+void MinMoveSolver::generateChains(Bitboard pegs, size_t start, int hole) {
+    for (int id : shape.jumpsFrom(hole)) {
+        const Jump& jump = shape.getJumps()[id];
+        if (!canJump(pegs, jump)) continue;
+
+        Bitboard next = applyJump(pegs, jump);
+
+        // Different chains of the same marble can end in the same position
+        bool seen = false;
+        for (size_t i = start; i < children.size() && !seen; i++) {
+            seen = children[i].state.pegs == next;
+        }
+        if (!seen) {
+            Child child;
+            child.state = BoardState::from(next);
+            child.state.lastLanding = static_cast<int8_t>(jump.to);
+            child.bound = lowerBound(next);
+            overflow = !children.push(child) || overflow;
+        }
+
+        generateChains(next, start, jump.to);
+    }
+}
+
+bool MinMoveSolver::search(const BoardState& state, int budget) {
+    nodes++;
+
+    if (isGoal(state.pegs)) {
+        return true;
+    }
+    if (lowerBound(state.pegs) > budget) {
+        return false;
+    }
+
+    // Skip positions already shown to need more than this many moves
+    Bitboard key = shape.canonical(state.pegs, symmetryMask);
+    int failedBudget;
+    if (table.probe(key, failedBudget) && failedBudget >= budget) {
+        return false;
+    }
+
+    // This ply's moves go on top of the flat stack and are dropped on return
+    size_t first = children.size();
+
+    // The marble that just landed is not moved again: continuing with it
+    // would have been part of the previous move
+    Bitboard movers = state.pegs;
+    if (state.lastLanding >= 0) {
+        movers &= ~(Bitboard(1) << state.lastLanding);
+    }
+    while (movers) {
+        int hole = lowestBit(movers);
+        movers &= movers - 1;
+        generateChains(state.pegs, children.size(), hole);
+    }
+
+    // Insertion sort by bound: stable, in place and allocation-free
+    for (size_t i = first + 1; i < children.size(); i++) {
+        Child moving = children[i];
+        size_t j = i;
+        while (j > first && children[j - 1].bound > moving.bound) {
+            children[j] = children[j - 1];
+            j--;
+        }
+        children[j] = moving;
+    }
+
+    size_t last = children.size();
+    for (size_t i = first; i < last; i++) {
+        // Children are sorted, so once one is out of reach all the rest are
+        if (children[i].bound + 1 > budget) break;
+
+        path.push(children[i].state.pegs);
+        if (search(children[i].state, budget - 1)) {
+            return true;
+        }
+        path.pop();
+    }
+    children.truncate(first);
+
+    // Larger failed budgets prune more, so they are the entries worth keeping
+    table.store(key, budget, budget);
+    return false;
+}
+
+MoveChain MinMoveSolver::findChain(Bitboard from, Bitboard to) const {
+    MoveChain chain;
+    Bitboard candidates = from & ~to;
+    while (candidates) {
+        int hole = lowestBit(candidates);
+        candidates &= candidates - 1;
+
+        std::vector<int> holes(1, hole);
+        if (traceChain(shape, from, hole, to, holes)) {
+            for (int visited : holes) {
+                chain.push_back(shape.position(visited));
+            }
+            break;
+        }
+    }
+    return chain;
+}
@@ -0,0 +1,119 @@
+#include "move_evaluator.h"
+#include <algorithm>
+
+MoveEvaluator::MoveEvaluator(const BoardShape& shape, const MoveEvaluatorConfig& config)
+    : oracle(shape, config.tableMegabytes), counter(new SolutionCounter(shape, config.memoMegabytes)),
+      book(nullptr), countBelowPegs(config.countBelowPegs), nextTask(0), finished(0), generation(0), position(0),
+      stopping(false), seconds(0.0) {
+    int threads = config.threads;
+    if (threads <= 0) {
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(std::thread(&MoveEvaluator::worker, this));
+    }
+}
+
+MoveEvaluator::~MoveEvaluator() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+void MoveEvaluator::setBook(const OpeningBook* openingBook) {
+    book = openingBook;
+    oracle.setBook(openingBook);
+    counter->setBook(openingBook);
+}
+
+void MoveEvaluator::evaluate(Bitboard pegs) {
+    const std::vector<Jump>& jumps = oracle.getShape().getJumps();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        generation++;
+        position = pegs;
+        oracle.newSearch();
+        results.clear();
+        for (size_t id = 0; id < jumps.size(); id++) {
+            if (canJump(pegs, jumps[id])) {
+                MoveEvaluation pending;
+                pending.jump = static_cast<int>(id);
+                results.push_back(pending);
+            }
+        }
+        nextTask = 0;
+        finished = 0;
+        started = std::chrono::steady_clock::now();
+        seconds = 0.0;
+    }
+    wake.notify_all();
+}
+
+Bitboard MoveEvaluator::getPosition() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return position;
+}
+
+bool MoveEvaluator::getResults(std::vector<MoveEvaluation>& out) const {
+    std::lock_guard<std::mutex> guard(lock);
+    out.assign(results.begin(), results.end());
+    return finished == results.size();
+}
+
+double MoveEvaluator::getSeconds() const {
+    std::lock_guard<std::mutex> guard(lock);
+    if (finished == results.size()) {
+        return seconds;
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+void MoveEvaluator::worker() {
+    const std::vector<Jump>& jumps = oracle.getShape().getJumps();
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wake.wait(guard, [this]() { return stopping || nextTask < results.size(); });
+        if (stopping) {
+            return;
+        }
+
+        size_t index = nextTask++;
+        uint64_t task = generation;
+        int jump = results[index].jump;
+        Bitboard after = applyJump(position, jumps[jump]);
+
+        // The search runs unlocked; a new position meanwhile makes it moot
+        guard.unlock();
+        MoveEvaluation evaluation = judge(jump, after);
+        guard.lock();
+
+        if (task != generation) continue;
+        results[index] = evaluation;
+        if (++finished == results.size()) {
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        }
+    }
+}
+
+MoveEvaluation MoveEvaluator::judge(int jump, Bitboard after) {
+    MoveEvaluation evaluation;
+    evaluation.jump = jump;
+    evaluation.quality = oracle.solvable(after) ? MOVE_WINNABLE : MOVE_DEAD;
+
+    OpeningBookHit hit;
+    if (book && book->hasCounts() && book->lookup(after, hit)) {
+        evaluation.counted = true;
+        evaluation.solutions = hit.solutions;
+    } else if (evaluation.quality == MOVE_DEAD) {
+        evaluation.counted = true;
+    } else if (popCount(after) <= countBelowPegs) {
+        evaluation.counted = true;
+        evaluation.solutions = counter->count(after);
+    }
+    return evaluation;
+}
@@ -0,0 +1,130 @@
+#include "move_ordering.h"
+#include <algorithm>
+#include <cstdlib>
+
+void MoveOrderer::order(const BoardState& state, int* jumps, int count) {
+    prepare(state);
+
+    // Few jumps are ever legal at once, so scores fit on the stack
+    int64_t scores[256];
+    count = std::min(count, 256);
+    for (int i = 0; i < count; i++) {
+        scores[i] = score(state, jumps[i]);
+    }
+
+    // Insertion sort, stable so equal scores keep the generated order
+    for (int i = 1; i < count; i++) {
+        int jump = jumps[i];
+        int64_t value = scores[i];
+        int j = i;
+        while (j > 0 && scores[j - 1] < value) {
+            jumps[j] = jumps[j - 1];
+            scores[j] = scores[j - 1];
+            j--;
+        }
+        jumps[j] = jump;
+        scores[j] = value;
+    }
+}
+
+std::vector<std::string> MoveOrderer::names() {
+    std::vector<std::string> result;
+    result.push_back("fixed");
+    result.push_back("history");
+    result.push_back("killer");
+    result.push_back("mobility");
+    result.push_back("combined");
+    return result;
+}
+
+std::unique_ptr<MoveOrderer> MoveOrderer::create(const BoardShape& shape, const std::string& name) {
+    std::unique_ptr<MoveOrderer> orderer;
+    if (name == "fixed") {
+        orderer.reset(new FixedOrderer(shape));
+    } else if (name == "history") {
+        orderer.reset(new HistoryOrderer(shape));
+    } else if (name == "killer") {
+        orderer.reset(new KillerOrderer(shape));
+    } else if (name == "mobility") {
+        orderer.reset(new MobilityOrderer(shape));
+    } else if (name == "combined") {
+        orderer.reset(new CombinedOrderer(shape));
+    }
+    return orderer;
+}
+
+HistoryOrderer::HistoryOrderer(const BoardShape& shape)
+    : MoveOrderer(shape), history(shape.getJumps().size(), 0) {
+}
+
+void HistoryOrderer::reset() {
+    std::fill(history.begin(), history.end(), 0);
+}
+
+void HistoryOrderer::searched(int, int jumpId, int fewestPegs) {
+    // Each marble short of a solution halves the reward, so one near miss
+    // outweighs many lines that stalled early
+    int missing = std::min(fewestPegs - 1, 24);
+    history[jumpId] += int64_t(1) << (24 - missing);
+}
+
+void KillerOrderer::reset() {
+    for (int depth = 0; depth < MAX_DEPTH; depth++) {
+        killers[depth][0] = killers[depth][1] = -1;
+        bestPegs[depth] = 1 << 30;
+    }
+}
+
+void KillerOrderer::prepare(const BoardState& state) {
+    if (state.depth < MAX_DEPTH) {
+        bestPegs[state.depth] = 1 << 30;
+    }
+}
+
+int64_t KillerOrderer::score(const BoardState& state, int jumpId) {
+    if (state.depth >= MAX_DEPTH) return 0;
+    if (killers[state.depth][0] == jumpId) return 2;
+    if (killers[state.depth][1] == jumpId) return 1;
+    return 0;
+}
+
+void KillerOrderer::searched(int depth, int jumpId, int fewestPegs) {
+    if (depth >= MAX_DEPTH || fewestPegs >= bestPegs[depth]) return;
+
+    bestPegs[depth] = fewestPegs;
+    if (killers[depth][0] != jumpId) {
+        killers[depth][1] = killers[depth][0];
+        killers[depth][0] = jumpId;
+    }
+}
+
+int MobilityOrderer::mobility(Bitboard pegs, int jumpId) const {
+    const Jump& jump = shape.getJumps()[jumpId];
+    Bitboard next = applyJump(pegs, jump);
+
+    int followUps = 0;
+    for (const Jump& candidate : shape.getJumps()) {
+        followUps += canJump(next, candidate);
+    }
+
+    int center = shape.getSize() / 2;
+    Position landing = shape.position(jump.to);
+    int centrality = shape.getSize() - std::abs(landing.row - center) - std::abs(landing.col - center);
+
+    return 2 * std::min(followUps, 120) + std::max(centrality, 0);
+}
+
+void CombinedOrderer::reset() {
+    history.reset();
+    killer.reset();
+}
+
+void CombinedOrderer::searched(int depth, int jumpId, int fewestPegs) {
+    history.searched(depth, jumpId, fewestPegs);
+    killer.searched(depth, jumpId, fewestPegs);
+}
+
+int64_t CombinedOrderer::score(const BoardState& state, int jumpId) {
+    int64_t historyScore = std::min(history.score(state, jumpId), int64_t(1) << 47);
+    return (killer.score(state, jumpId) << 56) | (historyScore << 8) | mobilityScore.mobility(state.pegs, jumpId);
+}
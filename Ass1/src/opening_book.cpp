@@ -0,0 +1,243 @@
+#include "opening_book.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+#include "game_record.h"
+#include "solvability.h"
+
+namespace {
+
+const char BOOK_MAGIC[4] = {'M', 'S', 'O', 'B'};
+const uint32_t BOOK_VERSION = 1;
+const uint8_t NO_HOLE = 0xFF;
+
+bool entryBefore(const OpeningBookEntry& entry, Bitboard key) {
+    return entry.key < key;
+}
+
+} // namespace
+
+OpeningBook::OpeningBook(const std::string& path)
+    : mapping(nullptr), bytes(0), header(nullptr), entries(nullptr), count(0), shape(BoardShape::english()) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Cannot read opening book " << path << std::endl;
+        return;
+    }
+
+    struct stat info;
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(sizeof(OpeningBookHeader))) {
+        bytes = static_cast<size_t>(info.st_size);
+        memory = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        std::cerr << "Cannot map opening book " << path << std::endl;
+        return;
+    }
+
+    mapping = static_cast<const uint8_t*>(memory);
+    header = reinterpret_cast<const OpeningBookHeader*>(mapping);
+    if (std::memcmp(header->magic, BOOK_MAGIC, 4) != 0 || header->version != BOOK_VERSION ||
+        header->shape > RECORD_FRENCH ||
+        header->count != (bytes - sizeof(OpeningBookHeader)) / sizeof(OpeningBookEntry)) {
+        std::cerr << "Not a version " << BOOK_VERSION << " opening book: " << path << std::endl;
+        munmap(memory, bytes);
+        mapping = nullptr;
+        header = nullptr;
+        return;
+    }
+
+    shape = shapeForRecord(header->shape);
+    entries = reinterpret_cast<const OpeningBookEntry*>(mapping + sizeof(OpeningBookHeader));
+    count = header->count;
+    // Lookups land all over the file
+    madvise(memory, bytes, MADV_RANDOM);
+}
+
+OpeningBook::~OpeningBook() {
+    if (mapping) {
+        munmap(const_cast<uint8_t*>(mapping), bytes);
+    }
+}
+
+const OpeningBookEntry* OpeningBook::find(Bitboard key) const {
+    size_t low = 0, high = count;
+
+    // Keys are spread fairly evenly, so a few interpolation steps usually
+    // land on or next to the entry; a binary search finishes whatever is left
+    for (int step = 0; step < 4 && high - low > 16; step++) {
+        Bitboard lowKey = entries[low].key;
+        Bitboard highKey = entries[high - 1].key;
+        if (key < lowKey || key > highKey) {
+            return nullptr;
+        }
+        size_t guess = low + static_cast<size_t>(double(key - lowKey) / double(highKey - lowKey) * (high - 1 - low));
+        if (entries[guess].key == key) {
+            return &entries[guess];
+        }
+        if (entries[guess].key < key) {
+            low = guess + 1;
+        } else {
+            high = guess;
+        }
+    }
+
+    const OpeningBookEntry* found = std::lower_bound(entries + low, entries + high, key, entryBefore);
+    return found != entries + high && found->key == key ? found : nullptr;
+}
+
+bool OpeningBook::lookup(Bitboard pegs, OpeningBookHit& hit) const {
+    if (!entries) {
+        return false;
+    }
+    Bitboard key = shape.canonical(pegs);
+    const OpeningBookEntry* entry = find(key);
+    if (!entry) {
+        return false;
+    }
+
+    hit.solvable = entry->solvable != 0;
+    hit.counted = hasCounts();
+    hit.solutions = (SolutionCount(entry->countHigh) << 64) | entry->countLow;
+    hit.bestJump = -1;
+    if (entry->bestFrom == NO_HOLE) {
+        return true;
+    }
+
+    // Turn the stored jump back into the orientation that was asked about
+    int symmetries = shape.getSymmetryMask();
+    for (int sym = 0; sym < BoardShape::MAX_SYMMETRIES; sym++) {
+        if (!((symmetries >> sym) & 1) || shape.transform(pegs, sym) != key) continue;
+
+        int from = -1, to = -1;
+        for (Bitboard holes = shape.getHoles(); holes; holes &= holes - 1) {
+            int hole = lowestBit(holes);
+            if (shape.transformHole(hole, sym) == entry->bestFrom) from = hole;
+            if (shape.transformHole(hole, sym) == entry->bestTo) to = hole;
+        }
+        hit.bestJump = shape.findJump(from, to);
+        break;
+    }
+    return true;
+}
+
+bool OpeningBook::build(const BoardShape& shape, Bitboard start, const OpeningBookConfig& config,
+                        const std::string& path) {
+    uint8_t shapeId;
+    if (!recordShapeFor(shape, shapeId)) {
+        std::cerr << "Opening books are only built for the English and French boards" << std::endl;
+        return false;
+    }
+
+    // Canonical positions a layer at a time; layers never overlap, since
+    // every jump removes a marble
+    const std::vector<Jump>& jumps = shape.getJumps();
+    std::vector<Bitboard> keys, layer(1, shape.canonical(start)), next;
+    for (int ply = 0;; ply++) {
+        keys.insert(keys.end(), layer.begin(), layer.end());
+        std::cout << "Ply " << ply << ": " << layer.size() << " positions" << std::endl;
+        if (ply == config.plies) break;
+
+        next.clear();
+        for (Bitboard pegs : layer) {
+            for (const Jump& jump : jumps) {
+                if (canJump(pegs, jump)) {
+                    next.push_back(shape.canonical(applyJump(pegs, jump)));
+                }
+            }
+        }
+        std::sort(next.begin(), next.end());
+        next.erase(std::unique(next.begin(), next.end()), next.end());
+        if (next.empty()) break;
+        layer.swap(next);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    SolvabilityOracle oracle(shape, config.tableMegabytes);
+    std::unique_ptr<SolutionCounter> counter;
+    if (config.counts) {
+        counter.reset(new SolutionCounter(shape, config.memoMegabytes));
+    }
+
+    // Positions are independent; the table and memo they share are thread-safe
+    std::vector<OpeningBookEntry> book(keys.size());
+    std::atomic<size_t> nextIndex(0);
+    auto solve = [&]() {
+        for (size_t i; (i = nextIndex.fetch_add(1)) < keys.size();) {
+            OpeningBookEntry& entry = book[i];
+            std::memset(&entry, 0, sizeof(entry));
+            entry.key = keys[i];
+
+            // With counts, the best jump leaves the most winning continuations
+            int best = -1;
+            if (counter) {
+                SolutionCount total = popCount(keys[i]) == 1 ? 1 : 0, bestCount = 0;
+                for (size_t id = 0; id < jumps.size(); id++) {
+                    if (!canJump(keys[i], jumps[id])) continue;
+                    SolutionCount solutions = counter->count(applyJump(keys[i], jumps[id]));
+                    total += solutions;
+                    if (solutions > bestCount) {
+                        bestCount = solutions;
+                        best = static_cast<int>(id);
+                    }
+                }
+                entry.countLow = static_cast<uint64_t>(total);
+                entry.countHigh = static_cast<uint64_t>(total >> 64);
+                entry.solvable = total > 0;
+            } else {
+                best = oracle.winningJump(keys[i]);
+                entry.solvable = popCount(keys[i]) == 1 || best >= 0;
+            }
+
+            entry.bestFrom = best >= 0 ? static_cast<uint8_t>(jumps[best].from) : NO_HOLE;
+            entry.bestTo = best >= 0 ? static_cast<uint8_t>(jumps[best].to) : NO_HOLE;
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < config.threads; t++) {
+        workers.push_back(std::thread(solve));
+    }
+    solve();
+    for (size_t t = 0; t < workers.size(); t++) {
+        workers[t].join();
+    }
+
+    OpeningBookHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BOOK_MAGIC, 4);
+    header.version = BOOK_VERSION;
+    header.shape = shapeId;
+    header.plies = static_cast<uint8_t>(config.plies);
+    header.flags = config.counts ? BOOK_HAS_COUNTS : 0;
+    header.start = start;
+    header.count = book.size();
+
+    // Written beside the target first, so a reader never maps half a book
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Cannot write " << temporary << std::endl;
+        return false;
+    }
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fwrite(book.data(), sizeof(OpeningBookEntry), book.size(), file);
+    bool ok = std::ferror(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to write " << path << std::endl;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,179 @@
+#include "puzzle_generator.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+PuzzleWriter::PuzzleWriter(const std::string& path, const BoardShape& shape)
+    : out(path.c_str(), std::ios::binary | std::ios::trunc), written(0) {
+    if (!out.is_open()) {
+        return;
+    }
+
+    // Header: magic, version, board size, then the hole mask
+    char header[16] = {'M', 'S', 'P', 'Z', 1, static_cast<char>(shape.getSize()), 0, 0};
+    Bitboard holes = shape.getHoles();
+    for (int i = 0; i < 8; i++) {
+        header[8 + i] = static_cast<char>((holes >> (8 * i)) & 0xFF);
+    }
+    out.write(header, sizeof(header));
+}
+
+PuzzleWriter::~PuzzleWriter() {
+    if (out.is_open()) {
+        out.write(buffer.data(), buffer.size());
+    }
+}
+
+void PuzzleWriter::write(const Puzzle& puzzle) {
+    char record[11];
+    for (int i = 0; i < 8; i++) {
+        record[i] = static_cast<char>((puzzle.pegs >> (8 * i)) & 0xFF);
+    }
+    record[8] = static_cast<char>(puzzle.finishHole);
+    record[9] = static_cast<char>(popCount(puzzle.pegs));
+    record[10] = static_cast<char>(puzzle.difficulty);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer.append(record, sizeof(record));
+    written++;
+
+    // Stream out in large blocks rather than one record at a time
+    if (buffer.size() >= (1 << 16)) {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+PuzzleGenerator::PuzzleGenerator(const BoardShape& boardShape) : shape(boardShape), accepted(0) {
+}
+
+uint64_t PuzzleGenerator::generate(const PuzzleGeneratorConfig& config, PuzzleWriter& writer) {
+    seen.clear();
+    accepted = 0;
+
+    int threads = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(threads, 1);
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(std::thread(&PuzzleGenerator::worker, this, i, std::cref(config), std::ref(writer)));
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    return accepted;
+}
+
+bool PuzzleGenerator::markSeen(Bitboard canonical) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return seen.insert(canonical).second;
+}
+
+bool PuzzleGenerator::reserveSlot(uint64_t limit) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (accepted >= limit) {
+        return false;
+    }
+    accepted++;
+    return true;
+}
+
+void PuzzleGenerator::worker(int threadIndex, const PuzzleGeneratorConfig& config, PuzzleWriter& writer) {
+    // One reproducible stream per thread
+    std::seed_seq seeds{static_cast<uint32_t>(config.seed), static_cast<uint32_t>(config.seed >> 32),
+                        static_cast<uint32_t>(threadIndex)};
+    std::mt19937_64 rng(seeds);
+
+    std::vector<int> scratch;
+    CountMemo memo;
+    // Candidates rejected in a row, whatever the reason: a failed grow, a
+    // duplicate or a difficulty out of range. Small marble counts run out of
+    // distinct boards, and some difficulty ranges are empty.
+    int rejected = 0;
+
+    while (rejected < PUZZLE_MAX_REJECTIONS) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (accepted >= config.count) break;
+        }
+
+        Puzzle puzzle;
+        if (!grow(puzzle.pegs, puzzle.finishHole, config.pegs, rng, scratch) ||
+            !markSeen(shape.canonical(puzzle.pegs))) {
+            rejected++;
+            continue;
+        }
+
+        // The memo only pays off within one puzzle's subtree
+        memo.clear();
+        Counts counts = count(puzzle.pegs, memo);
+        puzzle.solutions = counts.wins;
+        puzzle.difficulty = static_cast<int>(std::floor(std::log2(counts.total / counts.wins)));
+        puzzle.difficulty = std::min(puzzle.difficulty, 255);
+
+        if (puzzle.difficulty < config.minDifficulty || puzzle.difficulty > config.maxDifficulty) {
+            rejected++;
+            continue;
+        }
+        if (!reserveSlot(config.count)) {
+            break;
+        }
+        writer.write(puzzle);
+        rejected = 0;
+    }
+}
+
+bool PuzzleGenerator::grow(Bitboard& pegs, int& finishHole, int targetPegs, std::mt19937_64& rng,
+                           std::vector<int>& scratch) const {
+    if (targetPegs < 1 || targetPegs >= shape.getHoleCount()) {
+        return false;
+    }
+
+    // Start from a single marble on a random hole
+    std::uniform_int_distribution<int> pickHole(0, shape.getHoleCount() - 1);
+    Bitboard holes = shape.getHoles();
+    for (int skip = pickHole(rng); skip > 0; skip--) {
+        holes &= holes - 1;
+    }
+    finishHole = lowestBit(holes);
+    pegs = Bitboard(1) << finishHole;
+
+    // Each unjump adds one marble; playing them back in reverse solves the board
+    while (popCount(pegs) < targetPegs) {
+        shape.legalUnjumps(pegs, scratch);
+        if (scratch.empty()) {
+            return false;
+        }
+        std::uniform_int_distribution<size_t> pick(0, scratch.size() - 1);
+        pegs = applyJump(pegs, shape.getJumps()[scratch[pick(rng)]]);
+    }
+    return true;
+}
+
+PuzzleGenerator::Counts PuzzleGenerator::count(Bitboard pegs, CountMemo& memo) const {
+    Bitboard key = shape.canonical(pegs);
+    CountMemo::const_iterator it = memo.find(key);
+    if (it != memo.end()) {
+        return it->second;
+    }
+
+    Counts counts = {0.0, 0.0};
+    const std::vector<Jump>& jumps = shape.getJumps();
+    for (size_t id = 0; id < jumps.size(); id++) {
+        if (canJump(pegs, jumps[id])) {
+            Counts child = count(applyJump(pegs, jumps[id]), memo);
+            counts.total += child.total;
+            counts.wins += child.wins;
+        }
+    }
+
+    // No move left: the game ends here
+    if (counts.total == 0.0) {
+        counts.total = 1.0;
+        counts.wins = popCount(pegs) == 1 ? 1.0 : 0.0;
+    }
+
+    memo[key] = counts;
+    return counts;
+}
@@ -1,11 +1,22 @@
 #include "../include/renderer.h"
 #include <../external/imgui/imgui.h>
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <string>
 #include <glm/gtc/matrix_transform.hpp>
 #include <../include/renderer.h>
 #include <../include/theme.h>
-Renderer::Renderer(int width, int height) : windowWidth(width), windowHeight(height)
+
+// Boards per row of the wall snapshot texture
+static const int WALL_TEXTURE_WIDTH = 256;
+// Side of the precomputed marble: about a marble's size on a 7x7 board at 800 pixels
+static const int MARBLE_SPRITE_SIZE = 64;
+Renderer::Renderer(int width, int height)
+    : windowWidth(width), windowHeight(height), quadVAO(0), quadVBO(0), themeUBO(0), animator(nullptr),
+      boardTexture(0), boardTextureSize(0), boardUniformSize(0), wallTexture(0), wallTextureRows(0), boardMode(BOARD_GEOMETRY),
+      quality(QUALITY_FULL), renderScale(1.0f), lowCostFBO(0), lowCostColor(0), lowCostWidth(0), lowCostHeight(0),
+      lowCostValid(false), spriteTexture(0)
 {
     // Initialize member variables
 }
@@ -13,17 +24,40 @@ Renderer::Renderer(int width, int height) : windowWidth(width), windowHeight(hei
 Renderer::~Renderer()
 {
     // Clean up OpenGL resources
-    glDeleteVertexArrays(1, &squareVAO);
-    glDeleteBuffers(1, &squareVBO);
+    glDeleteVertexArrays(1, &quadVAO);
+    glDeleteBuffers(1, &quadVBO);
+    glDeleteBuffers(1, &themeUBO);
+
+    InstanceBatch* batches[] = {&cellBatch, &marbleBatch, &selectionBatch, &hintBatch, &overlayBatch, &animationBatch};
+    for (InstanceBatch* batch : batches) {
+        glDeleteVertexArrays(1, &batch->vao);
+        glDeleteBuffers(1, &batch->vbo);
+    }
 
-    glDeleteVertexArrays(1, &circleVAO);
-    glDeleteBuffers(1, &circleVBO);
+    glDeleteTextures(1, &boardTexture);
+    glDeleteTextures(1, &wallTexture);
+    glDeleteTextures(1, &spriteTexture);
+    glDeleteFramebuffers(1, &lowCostFBO);
+    glDeleteTextures(1, &lowCostColor);
 }
 #include <unistd.h>
 
 
 void Renderer::setTheme(const Theme& theme) {
     currentTheme = theme;
+    lowCostValid = false;
+    if (themeUBO) {
+        ThemeUniforms block = currentTheme.uniforms();
+        glBindBuffer(GL_UNIFORM_BUFFER, themeUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), &block);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+}
+
+void Renderer::setRenderQuality(RenderQuality value, float scale) {
+    quality = value;
+    renderScale = std::max(0.25f, std::min(scale, 1.0f));
+    lowCostValid = false;
 }
 
 void Renderer::init()
@@ -39,21 +73,24 @@ void Renderer::init()
 
     std::cout << "Loading shaders from: " << basePath << std::endl;
 
-    squareShader.loadFromFile((basePath + "square.vs").c_str(),
-                              (basePath + "square.fs").c_str());
+    // Every quad of the board goes through instance.vs; only the fragment stage differs
+    quadShader.loadFromFile((basePath + "instance.vs").c_str(),
+                            (basePath + "quad.fs").c_str());
 
-    circleShader.loadFromFile((basePath + "circle.vs").c_str(),
-                              (basePath + "circle.fs").c_str());
+    marbleShader.loadFromFile((basePath + "instance.vs").c_str(),
+                              (basePath + "marble.fs").c_str());
 
-                               // Add this line to load the highlight shader
-    highlightShader.loadFromFile((basePath + "square.vs").c_str(),
-    (basePath + "square.fs").c_str());  // We can reuse square shaders
+    overlayShader.loadFromFile((basePath + "instance.vs").c_str(),
+                               (basePath + "overlay.fs").c_str());
 
-    // Add this after shader loading in init():
-    // if (!circleShader.isValid())
-    // {
-    //     std::cerr << "Circle shader failed to compile!" << std::endl;
-    // }
+    spriteShader.loadFromFile((basePath + "instance.vs").c_str(),
+                              (basePath + "sprite.fs").c_str());
+
+    boardShader.loadFromFile((basePath + "board.vs").c_str(),
+                             (basePath + "board.fs").c_str());
+
+    wallShader.loadFromFile((basePath + "wall.vs").c_str(),
+                            (basePath + "wall.fs").c_str());
 
     // Check for shader compilation errors
     GLenum err = glGetError();
@@ -63,97 +100,127 @@ void Renderer::init()
     }
 
     // Create geometry
-    createSquare();
-    createCircle();
-    createHighlight();  // Make sure this method exists
-
+    createQuad();
+    createThemeBuffer();
+    InstanceBatch* batches[] = {&cellBatch, &marbleBatch, &selectionBatch, &hintBatch, &overlayBatch, &animationBatch};
+    for (InstanceBatch* batch : batches) {
+        createInstanced(*batch);
+    }
+    createBoardTexture();
+    createWallTexture();
+    createMarbleSprite();
+
+    // Samplers never change unit, so they are set once here rather than per draw
+    boardShader.use();
+    boardShader.setInt("board", 0);
+    wallShader.use();
+    wallShader.setInt("boards", 0);
+    wallShader.setInt("textureWidth", WALL_TEXTURE_WIDTH);
+    spriteShader.use();
+    spriteShader.setInt("sprite", 0);
+    glUseProgram(0);
 }
-void Renderer::createSquare()
+
+void Renderer::createQuad()
 {
-    // Define square vertices (using a simple quad)
     float vertices[] = {
-        -0.5f, -0.5f, // Bottom left
-        0.5f, -0.5f,  // Bottom right
-        0.5f, 0.5f,   // Top right
-        -0.5f, 0.5f   // Top left
+        -0.5f, -0.5f,  // Bottom left
+         0.5f, -0.5f,  // Bottom right
+         0.5f,  0.5f,  // Top right
+        -0.5f,  0.5f   // Top left
     };
 
-    // Create and configure VAO for square
-    glGenVertexArrays(1, &squareVAO);
-    glBindVertexArray(squareVAO);
+    glGenVertexArrays(1, &quadVAO);
+    glBindVertexArray(quadVAO);
 
-    // Create and configure VBO
-    glGenBuffers(1, &squareVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, squareVBO);
+    glGenBuffers(1, &quadVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-    // Configure vertex attributes
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
-    // Unbind
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
-void Renderer::createCircle()
+void Renderer::createThemeBuffer()
 {
-    std::cout << "Creating circle geometry..." << std::endl;
-
-    // Define vertices for a square with texture coordinates
-    float vertices[] = {
-        // Positions        // Texture Coords
-        -0.5f, -0.5f,       0.0f, 0.0f,   // Bottom left
-         0.5f, -0.5f,       1.0f, 0.0f,   // Bottom right
-         0.5f,  0.5f,       1.0f, 1.0f,   // Top right
-        -0.5f,  0.5f,       0.0f, 1.0f    // Top left
-    };
-
-    // Generate and bind VAO
-    glGenVertexArrays(1, &circleVAO);
-    glBindVertexArray(circleVAO);
+    // One std140 block for every program, bound once to its binding point
+    ThemeUniforms block = currentTheme.uniforms();
+    glGenBuffers(1, &themeUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, themeUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(block), &block, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, THEME_BLOCK_BINDING, themeUBO);
+
+    const Shader* shaders[] = {&quadShader, &marbleShader, &overlayShader, &spriteShader, &boardShader, &wallShader};
+    for (const Shader* shader : shaders) {
+        shader->bindUniformBlock("ThemeBlock", THEME_BLOCK_BINDING);
+    }
+}
 
-    // Generate and bind VBO
-    glGenBuffers(1, &circleVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, circleVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+void Renderer::createInstanced(InstanceBatch& batch)
+{
+    // The unit quad is shared; everything else is per instance
+    glGenVertexArrays(1, &batch.vao);
+    glBindVertexArray(batch.vao);
 
-    // Position attribute - stride is now 4 floats (position + texcoord)
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
-    // Texture coordinate attribute
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glGenBuffers(1, &batch.vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, batch.vbo);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offsetof(QuadInstance, center));
     glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), (void*)offsetof(QuadInstance, color));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-
-    std::cout << "Circle geometry created successfully" << std::endl;
 }
 
-void Renderer::createHighlight()
+void Renderer::createBoardTexture()
 {
-    // We can reuse squareVAO for the highlight, but if you want a dedicated VAO:
-    float vertices[] = {
-        -0.5f, -0.5f,  // Bottom left
-         0.5f, -0.5f,  // Bottom right
-         0.5f,  0.5f,  // Top right
-        -0.5f,  0.5f   // Top left
-    };
-
-    glGenVertexArrays(1, &highlightVAO);
-    glBindVertexArray(highlightVAO);
-
-    glGenBuffers(1, &highlightVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, highlightVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    // Integer texels, fetched exactly: no filtering, no mipmaps
+    glGenTextures(1, &boardTexture);
+    glBindTexture(GL_TEXTURE_2D, boardTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
 
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+void Renderer::createWallTexture()
+{
+    glGenTextures(1, &wallTexture);
+    glBindTexture(GL_TEXTURE_2D, wallTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+void Renderer::createMarbleSprite()
+{
+    std::vector<uint8_t> texels;
+    BoardLayout::buildMarbleSprite(MARBLE_SPRITE_SIZE, texels);
+
+    glGenTextures(1, &spriteTexture);
+    glBindTexture(GL_TEXTURE_2D, spriteTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, MARBLE_SPRITE_SIZE, MARBLE_SPRITE_SIZE, 0, GL_RG, GL_UNSIGNED_BYTE,
+                 texels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void Renderer::renderGame(const MarbleSolitaire &game)
@@ -165,6 +232,18 @@ void Renderer::renderGame(const MarbleSolitaire &game)
         std::cout << "Rendering game with " << game.getRemainingMarbles() << " marbles" << std::endl;
     }
 
+    if (animator) {
+        layout.setHiddenCells(animator->getHiddenCells());
+        lowCostLayout.setHiddenCells(animator->getHiddenCells());
+    }
+
+    // The low-cost board covers the whole window with its own copy: no clear at all
+    if (quality == QUALITY_LOW_COST) {
+        renderLowCost(game);
+        renderAnimation(game);
+        return;
+    }
+
     // Clear the screen with the theme background color
     glClearColor(
         currentTheme.BACKGROUND_COLOR.r,
@@ -174,163 +253,250 @@ void Renderer::renderGame(const MarbleSolitaire &game)
     );
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    renderBoard(game);
-    renderMarbles(game);
-    renderSelection(game);
+    if (boardMode == BOARD_TEXTURE) {
+        renderBoardTexture(game);
+    } else {
+        renderBoard(game);
+        renderMarbles(game);
+        renderSelection(game);
+    }
+    renderAnimation(game);
     renderGameInfo(game);
 }
 
 void Renderer::renderBoard(const MarbleSolitaire& game) {
-    // Use orthographic projection for 2D rendering
-    glm::mat4 projection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f);
-
-    // Set up shader
-    squareShader.use();
-    squareShader.setMat4("projection", projection);
-
-    // Calculate cell size based on board size and theme parameters
-    float cellSize = currentTheme.BOARD_WIDTH / game.getBoardSize();
-
-    // Render each cell of the board
-    for (int row = 0; row < game.getBoardSize(); row++) {
-        for (int col = 0; col < game.getBoardSize(); col++) {
-            if (game.getCell(row, col) == INVALID)
-                continue;
-
-            // Calculate position using theme constants
-            float x = currentTheme.BOARD_ORIGIN_X + cellSize * col + cellSize * 0.5f;
-            float y = currentTheme.BOARD_ORIGIN_Y - cellSize * row - cellSize * 0.5f;
-
-            // Set transformation
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, glm::vec3(x, y, 0.0f));
-            model = glm::scale(model, glm::vec3(cellSize * currentTheme.CELL_SCALE_FACTOR,
-                                                cellSize * currentTheme.CELL_SCALE_FACTOR, 1.0f));
-            squareShader.setMat4("transform", model);
-
-            // Set color from theme
-            squareShader.setVec4("color", currentTheme.BOARD_COLOR);
-
-            // Draw square
-            glBindVertexArray(squareVAO);
-            glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-        }
-    }
+    // Instances are worked out first, then every cell goes in one draw
+    layout.buildCells(game, currentTheme);
+    drawInstances(quadShader, cellBatch, layout.getCells());
 }
 
-
-
 void Renderer::renderMarbles(const MarbleSolitaire &game)
 {
-    // Debug: Count marbles to render
-    int marbleCount = 0;
-    for (int row = 0; row < game.getBoardSize(); row++)
-    {
-        for (int col = 0; col < game.getBoardSize(); col++)
-        {
-            if (game.getCell(row, col) == MARBLE)
-            {
-                marbleCount++;
-            }
-        }
-    }
+    layout.buildMarbles(game, currentTheme);
+    const std::vector<QuadInstance>& marbles = layout.getMarbles();
+
+    // Debug: report the marble count whenever it changes
     static int lastRenderedCount = -1;
-    if (marbleCount != lastRenderedCount)
+    if (static_cast<int>(marbles.size()) != lastRenderedCount)
     {
-        std::cout << "About to render " << marbleCount << " marbles" << std::endl;
-        lastRenderedCount = marbleCount;
+        std::cout << "About to render " << marbles.size() << " marbles" << std::endl;
+        lastRenderedCount = static_cast<int>(marbles.size());
     }
-    // // Use orthographic projection for 2D rendering
-    glm::mat4 projection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f);
-    // squareShader.use();
-    // squareShader.setMat4("projection", projection);
-
-    // // Create a bright green square in the center of screen
-    // glm::mat4 testModel = glm::mat4(1.0f);
-    // testModel = glm::translate(testModel, glm::vec3(0.0f, 0.0f, 0.0f)); // Center of screen
-    // testModel = glm::scale(testModel, glm::vec3(0.5f, 0.5f, 1.0f)); // Large square
-    // squareShader.setMat4("transform", testModel);
-    // squareShader.setVec4("color", glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)); // Bright green
-
-    // // Draw the test square
-    // glBindVertexArray(squareVAO);
-    // glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-
-    // // Check for OpenGL errors
-    // GLenum err = glGetError();
-    // if (err != GL_NO_ERROR) {
-    //     std::cerr << "OpenGL error during test square rendering: " << err << std::endl;
-    // }
-    // Calculate cell size based on board size
-    // Calculate cell size based on board size and theme parameters
-    float cellSize = currentTheme.BOARD_WIDTH / game.getBoardSize();
-    float marbleSize = cellSize * currentTheme.MARBLE_SCALE_FACTOR;
-    // Enable depth testing to ensure proper ordering
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
+
     // Enable blending for better-looking circles
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // Bind circle shader for drawing marbles
-    circleShader.use();
-    circleShader.setMat4("projection", projection);
-    // Try using the square shader first (for debugging)
-    // squareShader.use();
-    // squareShader.setMat4("projection", projection);
-
-    // Debug output - print the first marble position
-    // static bool first_log_done = false;
-    int debugCount = 0;
-    // Render marbles
-    for (int row = 0; row < game.getBoardSize(); row++)
-    {
-        for (int col = 0; col < game.getBoardSize(); col++)
-        {
-            if (game.getCell(row, col) == MARBLE)
-            {
-                // Calculate position
-                // Calculate position using theme constants
-                float x = currentTheme.BOARD_ORIGIN_X + cellSize * col + cellSize * 0.5f;
-                float y = currentTheme.BOARD_ORIGIN_Y - cellSize * row - cellSize * 0.5f;
-                // // Print first few marble positions for debugging
-                // if (debugCount < 3) {
-                //     std::cout << "Marble " << debugCount << " at position (" << row << "," << col
-                //               << ") rendering at screen position (" << x << "," << y << ")" << std::endl;
-                //     debugCount++;
-                // }
-
-                // Set transformation
-                glm::mat4 model = glm::mat4(1.0f);
-                model = glm::translate(model, glm::vec3(x, y, currentTheme.MARBLE_Z_POSITION));
-                model = glm::scale(model, glm::vec3(marbleSize, marbleSize, 1.0f));
-                // squareShader.setMat4("transform", model);
-                // // Alternate colors for debugging
-                // float r = ((row + col) % 2 == 0) ? 1.0f : 0.8f;
-                // float b = ((row + col) % 2 == 0) ? 0.0f : 0.8f;
-                // // Set marble color to bright RED (for visibility)
-                // squareShader.setVec4("color", glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
-
-                // // Draw square (instead of circle) for testing
-                // glBindVertexArray(squareVAO);
-                // glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-                circleShader.setMat4("transform", model);
-
-                // // Set marble color to bright blue (different color than squares)
-                circleShader.setVec4("color", currentTheme.MARBLE_COLOR);
-
-                // // Draw circle
-                glBindVertexArray(circleVAO);
-                glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-                // glDrawElements(GL_TRIANGLE_FAN, 4, GL_UNSIGNED_INT, 0);
-            }
-        }
+    drawInstances(marbleShader, marbleBatch, marbles);
+
+    glDisable(GL_BLEND);
+}
+
+void Renderer::drawInstances(const Shader& shader, InstanceBatch& batch, const std::vector<QuadInstance>& instances)
+{
+    if (instances.empty()) {
+        return;
     }
 
-    // Disable blending
+    // Grow the buffer only when needed; otherwise overwrite it in place
+    glBindBuffer(GL_ARRAY_BUFFER, batch.vbo);
+    if (instances.size() > batch.capacity) {
+        batch.capacity = std::max(instances.size(), size_t(64));
+        glBufferData(GL_ARRAY_BUFFER, batch.capacity * sizeof(QuadInstance), nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(QuadInstance), instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    shader.use();
+    glBindVertexArray(batch.vao);
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, static_cast<GLsizei>(instances.size()));
+    glBindVertexArray(0);
+}
+
+void Renderer::renderBoardTexture(const MarbleSolitaire &game)
+{
+    layout.buildTexels(game, pendingHint);
+    pendingHint = Move();
+
+    // Only the texels that changed since the last frame go to the GPU
+    glBindTexture(GL_TEXTURE_2D, boardTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    int size = layout.getTexelSize();
+    if (size != boardTextureSize) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, size, size, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE,
+                     layout.getTexels().data());
+        boardTextureSize = size;
+    } else if (!layout.getDirtyTexels().empty()) {
+        const TexelRect& dirty = layout.getDirtyTexels();
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, size);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, dirty.x, dirty.y, dirty.width, dirty.height, GL_RED_INTEGER,
+                        GL_UNSIGNED_BYTE, layout.getTexels().data() + dirty.y * size + dirty.x);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+
+    // Everything else the pass needs is in the theme block
+    boardShader.use();
+    if (size != boardUniformSize) {
+        boardShader.setInt("boardSize", size);
+        boardUniformSize = size;
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Board, marbles, selection and hint in one pass over the board
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
     glDisable(GL_BLEND);
+}
+
+void Renderer::renderWall(const BoardShape &shape, const std::vector<WallBoard> &boards, bool changed)
+{
+    if (boards.empty()) {
+        return;
+    }
+
+    // The whole snapshot is a few kilobytes: full rows, then the partial last one
+    int count = static_cast<int>(boards.size());
+    int rows = (count + WALL_TEXTURE_WIDTH - 1) / WALL_TEXTURE_WIDTH;
+    glBindTexture(GL_TEXTURE_2D, wallTexture);
+    if (rows > wallTextureRows) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32UI, WALL_TEXTURE_WIDTH, rows, 0, GL_RGBA_INTEGER,
+                     GL_UNSIGNED_INT, nullptr);
+        wallTextureRows = rows;
+        changed = true;
+    }
+    if (changed) {
+        int fullRows = count / WALL_TEXTURE_WIDTH;
+        int rest = count % WALL_TEXTURE_WIDTH;
+        if (fullRows > 0) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, WALL_TEXTURE_WIDTH, fullRows, GL_RGBA_INTEGER,
+                            GL_UNSIGNED_INT, boards.data());
+        }
+        if (rest > 0) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, fullRows, rest, 1, GL_RGBA_INTEGER, GL_UNSIGNED_INT,
+                            boards.data() + fullRows * WALL_TEXTURE_WIDTH);
+        }
+    }
+
+    // As square a grid as the count allows
+    int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+    int tileRows = (count + columns - 1) / columns;
+
+    Bitboard holes = shape.getHoles();
+    wallShader.use();
+    wallShader.setInt("boardSize", shape.getSize());
+    glUniform2ui(glGetUniformLocation(wallShader.ID, "holes"), static_cast<GLuint>(holes),
+                 static_cast<GLuint>(holes >> 32));
+    wallShader.setInt("columns", columns);
+    wallShader.setVec2("tileSize", glm::vec2(2.0f / columns, 2.0f / tileRows));
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(quadVAO);
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, count);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Renderer::renderLowCost(const MarbleSolitaire &game)
+{
+    GLint viewport[4], target;
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+
+    int width = std::max(1, static_cast<int>(windowWidth * renderScale));
+    int height = std::max(1, static_cast<int>(windowHeight * renderScale));
+    if (width != lowCostWidth || height != lowCostHeight) {
+        if (!lowCostFBO) {
+            glGenFramebuffers(1, &lowCostFBO);
+            glGenTextures(1, &lowCostColor);
+        }
+        glBindTexture(GL_TEXTURE_2D, lowCostColor);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, lowCostFBO);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, lowCostColor, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        lowCostWidth = width;
+        lowCostHeight = height;
+        lowCostValid = false;
+    }
+
+    // The texel diff says which cells changed: marbles, selection or board size
+    lowCostLayout.buildTexels(game, Move());
+    int size = game.getBoardSize();
+    TexelRect dirty = lowCostLayout.getDirtyTexels();
+    if (!lowCostValid) {
+        dirty.x = dirty.y = 0;
+        dirty.width = dirty.height = size;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, lowCostFBO);
+    glViewport(0, 0, width, height);
     glDisable(GL_DEPTH_TEST);
+
+    if (!dirty.empty()) {
+        float cellSize = currentTheme.BOARD_WIDTH / size;
+        glClearColor(
+            currentTheme.BACKGROUND_COLOR.r,
+            currentTheme.BACKGROUND_COLOR.g,
+            currentTheme.BACKGROUND_COLOR.b,
+            currentTheme.BACKGROUND_COLOR.a
+        );
+        if (lowCostValid) {
+            // Only the changed cells' pixels, with a pixel to spare for rounding
+            float left = currentTheme.BOARD_ORIGIN_X + cellSize * dirty.x;
+            float top = currentTheme.BOARD_ORIGIN_Y - cellSize * dirty.y;
+            int x0 = static_cast<int>(std::floor((left + 1.0f) * 0.5f * width)) - 1;
+            int x1 = static_cast<int>(std::ceil((left + cellSize * dirty.width + 1.0f) * 0.5f * width)) + 1;
+            int y0 = static_cast<int>(std::floor((top - cellSize * dirty.height + 1.0f) * 0.5f * height)) - 1;
+            int y1 = static_cast<int>(std::ceil((top + 1.0f) * 0.5f * height)) + 1;
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(x0, y0, x1 - x0, y1 - y0);
+        }
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        // Cells first, then marbles over them, then the selection: as renderGame does
+        lowCostLayout.buildCells(game, currentTheme, &dirty);
+        drawInstances(quadShader, cellBatch, lowCostLayout.getCells());
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        lowCostLayout.buildMarbles(game, currentTheme, &dirty);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, spriteTexture);
+        drawInstances(spriteShader, marbleBatch, lowCostLayout.getMarbles());
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        Position selected = game.getSelectedPosition();
+        if (selected.isValid() && selected.row >= dirty.y && selected.row < dirty.y + dirty.height &&
+            selected.col >= dirty.x && selected.col < dirty.x + dirty.width) {
+            lowCostLayout.buildHighlights(game, currentTheme, &selected, 1, currentTheme.selectionColor());
+            drawInstances(quadShader, selectionBatch, lowCostLayout.getHighlights());
+        }
+
+        glBindVertexArray(0);
+        glDisable(GL_BLEND);
+        glDisable(GL_SCISSOR_TEST);
+        lowCostValid = true;
+    }
+
+    // A straight copy to the window replaces clearing it
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, lowCostFBO);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+    glBlitFramebuffer(0, 0, width, height, viewport[0], viewport[1], viewport[0] + viewport[2],
+                      viewport[1] + viewport[3], GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
 }
+
 void Renderer::renderSelection(const MarbleSolitaire &game)
 {
     Position selected = game.getSelectedPosition();
@@ -340,46 +506,75 @@ void Renderer::renderSelection(const MarbleSolitaire &game)
         return;
     }
 
-    // Use orthographic projection
-    glm::mat4 projection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f);
+    // Enable blending for transparent highlight
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    layout.buildHighlights(game, currentTheme, &selected, 1, currentTheme.selectionColor());
+    drawInstances(quadShader, selectionBatch, layout.getHighlights());
 
-    // Calculate cell size based on board size
-    float cellSize = currentTheme.BOARD_WIDTH / game.getBoardSize();
+    // Disable blending
+    glDisable(GL_BLEND);
+}
+void Renderer::renderHint(const MarbleSolitaire &game, const Move &hint)
+{
+    if (!hint.from.isValid() || !hint.to.isValid()) {
+        return;
+    }
+    if (boardMode == BOARD_TEXTURE) {
+        pendingHint = hint;
+        return;
+    }
 
-    // Calculate position
-    float x = currentTheme.BOARD_ORIGIN_X + cellSize * selected.col + cellSize * 0.5f;
-    float y = currentTheme.BOARD_ORIGIN_Y - cellSize * selected.row - cellSize * 0.5f;
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    const Position cells[] = {hint.from, hint.to};
+    layout.buildHighlights(game, currentTheme, cells, 2, currentTheme.hintColor());
+    drawInstances(quadShader, hintBatch, layout.getHighlights());
+
+    glDisable(GL_BLEND);
+}
+
+void Renderer::renderMoveOverlay(const MarbleSolitaire &game, const BoardShape &shape,
+                                 const std::vector<MoveEvaluation> &evaluations)
+{
+    layout.buildMoveOverlay(game, currentTheme, shape, evaluations);
 
-    // Enable blending for transparent highlight
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // Use the highlight shader
-    highlightShader.use();
-    highlightShader.setMat4("projection", projection);
+    drawInstances(overlayShader, overlayBatch, layout.getOverlay());
 
-    // Make highlight slightly larger than the cell
-    float highlightScale = cellSize * (currentTheme.CELL_SCALE_FACTOR + 0.05f);
+    glDisable(GL_BLEND);
+}
 
-    // Position highlight slightly above the board but below marbles
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(x, y, 0.05f));
-    model = glm::scale(model, glm::vec3(highlightScale, highlightScale, 1.0f));
-    highlightShader.setMat4("transform", model);
+void Renderer::renderAnimation(const MarbleSolitaire &game)
+{
+    // Nothing in flight: no upload, no draw
+    if (!animator || !animator->isActive()) {
+        return;
+    }
+    animator->buildInstances(game, currentTheme);
 
-    // Set a bright, semi-transparent highlight color
-    // If the theme color is too subtle, override it with a brighter one
-    glm::vec4 highlightColor = currentTheme.HIGHLIGHT_COLOR;
-    if (highlightColor.a < 0.4f) highlightColor.a = 0.4f;  // Ensure minimum opacity
-    highlightShader.setVec4("color", highlightColor);
+    // Over everything on the board, in the order the animator lists them
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // Draw the highlight using either dedicated VAO or square VAO
-    glBindVertexArray(highlightVAO != 0 ? highlightVAO : squareVAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    // The low-cost tier keeps its sprite for marbles in flight too
+    if (quality == QUALITY_LOW_COST) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, spriteTexture);
+        drawInstances(spriteShader, animationBatch, animator->getInstances());
+        glBindTexture(GL_TEXTURE_2D, 0);
+    } else {
+        drawInstances(marbleShader, animationBatch, animator->getInstances());
+    }
 
-    // Disable blending
     glDisable(GL_BLEND);
 }
+
 void Renderer::renderGameInfo(const MarbleSolitaire &game)
 {
     // Game info is rendered via ImGui in renderUI
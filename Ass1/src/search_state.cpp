@@ -0,0 +1,70 @@
+#include "search_state.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+Arena::Arena(size_t bytes) : memory(new char[bytes]), capacity(bytes), used(0), peak(0) {
+}
+
+Arena::~Arena() {
+    delete[] memory;
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    size_t start = (used + alignment - 1) & ~(alignment - 1);
+    if (start + bytes > capacity) {
+        return nullptr;
+    }
+    used = start + bytes;
+    if (used > peak) {
+        peak = used;
+    }
+    return memory + start;
+}
+
+// Counting replacements for the global allocation functions
+namespace {
+std::atomic<uint64_t> allocations(0);
+}
+
+uint64_t heapAllocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
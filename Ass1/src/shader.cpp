@@ -110,6 +110,13 @@ void Shader::setMat4(const std::string& name, const glm::mat4& mat) const {
     glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
 }
 
+void Shader::bindUniformBlock(const std::string& name, GLuint binding) const {
+    GLuint index = glGetUniformBlockIndex(ID, name.c_str());
+    if (index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(ID, index, binding);
+    }
+}
+
 void Shader::checkCompileErrors(GLuint shader, std::string type) {
     int success;
     char infoLog[1024];
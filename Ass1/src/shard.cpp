@@ -0,0 +1,189 @@
+#include "shard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+#include "solution_counter.h"
+
+namespace {
+
+void collectPrefixes(const BoardShape& shape, Bitboard pegs, int depth, std::vector<int>& jumps,
+                     std::vector<OpeningPrefix>& out) {
+    bool moved = false;
+    if (depth > 0) {
+        const std::vector<Jump>& all = shape.getJumps();
+        for (size_t id = 0; id < all.size(); id++) {
+            if (!canJump(pegs, all[id])) continue;
+            moved = true;
+            jumps.push_back(static_cast<int>(id));
+            collectPrefixes(shape, applyJump(pegs, all[id]), depth - 1, jumps, out);
+            jumps.pop_back();
+        }
+    }
+
+    if (!moved) {
+        OpeningPrefix prefix;
+        prefix.jumps = jumps;
+        prefix.pegs = pegs;
+        out.push_back(prefix);
+    }
+}
+
+} // namespace
+
+std::vector<OpeningPrefix> openingPrefixes(const BoardShape& shape, Bitboard start, int depth) {
+    std::vector<OpeningPrefix> prefixes;
+    std::vector<int> jumps;
+    collectPrefixes(shape, start, depth, jumps, prefixes);
+    return prefixes;
+}
+
+ShardResult runShard(const BoardShape& shape, Bitboard start, int depth, int shardIndex, int shardCount) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    ShardResult result;
+    result.shardIndex = shardIndex;
+    result.shardCount = shardCount;
+    result.depth = depth;
+    result.start = start;
+
+    std::vector<OpeningPrefix> prefixes = openingPrefixes(shape, start, depth);
+    result.prefixTotal = prefixes.size();
+
+    // One memo for the whole shard: its prefixes share most of their subtrees
+    SolutionCounter counter(shape);
+    for (size_t i = shardIndex; i < prefixes.size(); i += shardCount) {
+        PrefixResult prefix;
+        prefix.index = i;
+        prefix.solutions = counter.count(prefixes[i].pegs);
+        prefix.solvable = prefix.solutions > 0;
+        result.prefixes.push_back(prefix);
+    }
+
+    result.nodes = counter.getNodes();
+    result.memoEntries = counter.getMemoSize();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+bool writeShardResult(const std::string& path, const ShardResult& result) {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary.c_str());
+        out << "shard " << result.shardIndex << " " << result.shardCount << "\n";
+        out << "depth " << result.depth << "\n";
+        out << "start " << std::hex << result.start << std::dec << "\n";
+        out << "prefixes " << result.prefixTotal << "\n";
+        for (const PrefixResult& prefix : result.prefixes) {
+            out << "prefix " << prefix.index << " " << (prefix.solvable ? 1 : 0) << " "
+                << formatCount(prefix.solutions) << "\n";
+        }
+        out << "nodes " << result.nodes << "\n";
+        out << "memo " << result.memoEntries << "\n";
+        out << "seconds " << result.seconds << "\n";
+        out << "end\n";
+        if (!out.good()) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool readShardResult(const std::string& path, ShardResult& result) {
+    std::ifstream in(path.c_str());
+    if (!in.is_open()) {
+        return false;
+    }
+
+    result = ShardResult();
+    std::string key;
+    bool complete = false;
+    while (in >> key) {
+        if (key == "shard") {
+            in >> result.shardIndex >> result.shardCount;
+        } else if (key == "depth") {
+            in >> result.depth;
+        } else if (key == "start") {
+            in >> std::hex >> result.start >> std::dec;
+        } else if (key == "prefixes") {
+            in >> result.prefixTotal;
+        } else if (key == "prefix") {
+            PrefixResult prefix;
+            int solvable;
+            std::string solutions;
+            in >> prefix.index >> solvable >> solutions;
+            prefix.solvable = solvable != 0;
+            if (!parseCount(solutions, prefix.solutions)) {
+                return false;
+            }
+            result.prefixes.push_back(prefix);
+        } else if (key == "nodes") {
+            in >> result.nodes;
+        } else if (key == "memo") {
+            in >> result.memoEntries;
+        } else if (key == "seconds") {
+            in >> result.seconds;
+        } else if (key == "end") {
+            complete = true;
+        }
+    }
+    // A file without its end marker came from a worker that died mid-write
+    return complete && !in.bad();
+}
+
+bool mergeShardResults(const std::vector<ShardResult>& shards, MergedResult& merged, std::string& error) {
+    merged = MergedResult();
+    if (shards.empty()) {
+        error = "no shard results";
+        return false;
+    }
+
+    const ShardResult& first = shards.front();
+    if (first.shardCount <= 0) {
+        error = "shard count " + std::to_string(first.shardCount) + " is not positive";
+        return false;
+    }
+    std::vector<bool> seenShard(first.shardCount, false);
+    std::vector<bool> seenPrefix(first.prefixTotal, false);
+    std::vector<SolutionCount> solutions(first.prefixTotal, 0);
+    merged.solvable.assign(first.prefixTotal, false);
+
+    for (const ShardResult& shard : shards) {
+        if (shard.shardCount != first.shardCount || shard.depth != first.depth ||
+            shard.start != first.start || shard.prefixTotal != first.prefixTotal) {
+            error = "shards come from different analyses";
+            return false;
+        }
+        if (shard.shardIndex < 0 || shard.shardIndex >= shard.shardCount || seenShard[shard.shardIndex]) {
+            error = "duplicate or out-of-range shard " + std::to_string(shard.shardIndex);
+            return false;
+        }
+        seenShard[shard.shardIndex] = true;
+
+        for (const PrefixResult& prefix : shard.prefixes) {
+            if (prefix.index >= first.prefixTotal || seenPrefix[prefix.index]) {
+                error = "prefix " + std::to_string(prefix.index) + " reported twice or out of range";
+                return false;
+            }
+            seenPrefix[prefix.index] = true;
+            solutions[prefix.index] = prefix.solutions;
+            merged.solvable[prefix.index] = prefix.solvable;
+        }
+
+        merged.nodes += shard.nodes;
+        merged.cpuSeconds += shard.seconds;
+        merged.wallSeconds = std::max(merged.wallSeconds, shard.seconds);
+    }
+
+    for (uint64_t i = 0; i < first.prefixTotal; i++) {
+        if (!seenPrefix[i]) {
+            error = "prefix " + std::to_string(i) + " is missing";
+            return false;
+        }
+        // Summed in prefix order so the total never depends on shard timing
+        merged.solutions += solutions[i];
+        merged.solvablePrefixes += merged.solvable[i] ? 1 : 0;
+    }
+    return true;
+}
@@ -0,0 +1,326 @@
+#include "simulator.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+bool parsePolicy(const std::string& name, SimulationPolicy& policy) {
+    if (name == "random") {
+        policy = POLICY_RANDOM;
+    } else if (name == "greedy") {
+        policy = POLICY_GREEDY_MOBILITY;
+    } else if (name == "epsilon") {
+        policy = POLICY_EPSILON_SOLVER;
+    } else if (name == "mcts") {
+        policy = POLICY_MCTS;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* policyName(SimulationPolicy policy) {
+    switch (policy) {
+        case POLICY_RANDOM: return "random";
+        case POLICY_GREEDY_MOBILITY: return "greedy";
+        case POLICY_EPSILON_SOLVER: return "epsilon";
+        case POLICY_MCTS: return "mcts";
+    }
+    return "unknown";
+}
+
+void SimulationStats::reset(const BoardShape& shape) {
+    games = wins = 0;
+    finalPegs.assign(shape.getHoleCount() + 1, 0);
+    lengths.assign(shape.getHoleCount() + 1, 0);
+    holeEnds.assign(shape.getSize() * shape.getSize(), 0);
+    seconds = 0.0;
+}
+
+void SimulationStats::merge(const SimulationStats& other) {
+    games += other.games;
+    wins += other.wins;
+    for (size_t i = 0; i < finalPegs.size() && i < other.finalPegs.size(); i++) {
+        finalPegs[i] += other.finalPegs[i];
+        lengths[i] += other.lengths[i];
+    }
+    for (size_t i = 0; i < holeEnds.size() && i < other.holeEnds.size(); i++) {
+        holeEnds[i] += other.holeEnds[i];
+    }
+}
+
+Simulator::Simulator(const BoardShape& boardShape) : shape(boardShape) {
+}
+
+SimulationStats Simulator::run(Bitboard start, const SimulationConfig& config, GameRecordWriter* recorder) {
+    int threads = config.threads > 0 ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = std::max(threads, 1);
+
+    // Each epsilon-solver thread gets an equal share of the cache
+    size_t oracleMegabytes = 0;
+    if (config.policy == POLICY_EPSILON_SOLVER) {
+        oracleMegabytes = std::max(config.oracleMegabytes / threads, size_t(1));
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Fixed shares, so the games each stream plays never depend on timing
+    std::vector<SimulationStats> partial(threads);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+        partial[i].reset(shape);
+        uint64_t share = config.games / threads + (static_cast<uint64_t>(i) < config.games % threads ? 1 : 0);
+        workers.push_back(std::thread(&Simulator::worker, this, i, share, start, std::cref(config), oracleMegabytes,
+                                      std::ref(partial[i]), recorder));
+    }
+
+    SimulationStats total;
+    total.reset(shape);
+    for (int i = 0; i < threads; i++) {
+        workers[i].join();
+        total.merge(partial[i]);
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return total;
+}
+
+void Simulator::worker(int threadIndex, uint64_t games, Bitboard start, const SimulationConfig& config,
+                       size_t oracleMegabytes, SimulationStats& stats, GameRecordWriter* recorder) {
+    // One reproducible stream per thread
+    std::seed_seq seeds{static_cast<uint32_t>(config.seed), static_cast<uint32_t>(config.seed >> 32),
+                        static_cast<uint32_t>(threadIndex)};
+    std::mt19937_64 rng(seeds);
+
+    // The node pool is reserved once per thread and reused for every move
+    std::unique_ptr<MctsPlayer> player;
+    if (config.policy == POLICY_MCTS) {
+        MctsConfig mctsConfig;
+        mctsConfig.iterations = config.mctsIterations;
+        mctsConfig.poolNodes = std::min(size_t(1) << 20, static_cast<size_t>(config.mctsIterations) * 64 + 64);
+        player.reset(new MctsPlayer(shape, mctsConfig));
+    }
+
+    // A cache shared between threads would make what a budget proves depend
+    // on what the other threads happened to solve first
+    std::unique_ptr<TranspositionTable> oracle;
+    if (oracleMegabytes) {
+        oracle.reset(new TranspositionTable(oracleMegabytes));
+    }
+
+    GameRecordHeader header = GameRecordHeader();
+    header.start = start;
+    header.seed = config.seed;
+    if (recorder && !recordShapeFor(shape, header.shape)) {
+        recorder = nullptr;
+    }
+
+    const std::vector<Jump>& jumps = shape.getJumps();
+    int legal[256];
+    uint8_t played[256];
+    for (uint64_t game = 0; game < games; game++) {
+        Bitboard pegs = start;
+        int length = 0;
+        bool winnable = true;
+        std::chrono::system_clock::time_point gameStart;
+        if (recorder) {
+            gameStart = std::chrono::system_clock::now();
+        }
+        while (true) {
+            int count = 0;
+            for (size_t id = 0; id < jumps.size() && count < 256; id++) {
+                if (canJump(pegs, jumps[id])) {
+                    legal[count++] = static_cast<int>(id);
+                }
+            }
+            if (count == 0) break;
+
+            int id = chooseJump(pegs, legal, count, config, rng, winnable, player.get(), oracle.get());
+            pegs = applyJump(pegs, jumps[id]);
+            played[length++] = static_cast<uint8_t>(id);
+        }
+
+        if (recorder) {
+            auto now = std::chrono::system_clock::now();
+            header.jumps = static_cast<uint8_t>(length);
+            header.startMillis = std::chrono::duration_cast<std::chrono::milliseconds>(gameStart.time_since_epoch()).count();
+            header.durationMillis = static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(now - gameStart).count());
+            recorder->append(header, played);
+        }
+
+        int left = popCount(pegs);
+        stats.games++;
+        stats.wins += left == 1;
+        stats.finalPegs[left]++;
+        stats.lengths[length]++;
+        for (Bitboard rest = pegs; rest; rest &= rest - 1) {
+            stats.holeEnds[lowestBit(rest)]++;
+        }
+    }
+}
+
+int Simulator::chooseJump(Bitboard pegs, const int* legal, int count, const SimulationConfig& config,
+                          std::mt19937_64& rng, bool& winnable, MctsPlayer* player, TranspositionTable* oracle) {
+    std::uniform_int_distribution<int> pick(0, count - 1);
+    const std::vector<Jump>& jumps = shape.getJumps();
+
+    if (config.policy == POLICY_MCTS && count > 1) {
+        // A fresh seed per move keeps the games of one thread apart
+        player->setSeed(rng());
+        player->start(pegs);
+        player->step(config.mctsIterations, 0);
+        int best = player->getBestJump();
+        if (best >= 0) {
+            return best;
+        }
+    }
+
+    if (config.policy == POLICY_GREEDY_MOBILITY) {
+        // Reservoir sampling among the jumps with the most follow-ups
+        int best = -1, bestMobility = -1, ties = 0;
+        for (int i = 0; i < count; i++) {
+            Bitboard next = applyJump(pegs, jumps[legal[i]]);
+            int mobility = 0;
+            for (const Jump& jump : jumps) {
+                mobility += canJump(next, jump);
+            }
+            if (mobility > bestMobility) {
+                bestMobility = mobility;
+                best = legal[i];
+                ties = 1;
+            } else if (mobility == bestMobility && std::uniform_int_distribution<int>(0, ties++)(rng) == 0) {
+                best = legal[i];
+            }
+        }
+        return best;
+    }
+
+    // Once a game is lost the solver has nothing to add, so the rest is random
+    if (config.policy == POLICY_EPSILON_SOLVER && winnable &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(rng) >= config.epsilon) {
+        // Proving a jump loses can take far longer than proving one wins, so
+        // every jump gets a small budget first and the budget grows from
+        // there. Starting from a random jump spreads the games over equally
+        // good moves.
+        int first = pick(rng);
+        uint64_t limit = std::min(uint64_t(1000), config.oracleNodes);
+        while (true) {
+            bool unknown = false;
+            for (int i = 0; i < count; i++) {
+                int id = legal[(first + i) % count];
+                uint64_t budget = limit;
+                int result = solvable(applyJump(pegs, jumps[id]), budget, *oracle);
+                if (result > 0) {
+                    return id;
+                }
+                unknown = unknown || result < 0;
+            }
+            if (!unknown) {
+                winnable = false;   // Every jump is proven to lose
+                break;
+            }
+            if (limit == config.oracleNodes) {
+                break;              // Undecided: play this one at random
+            }
+            limit = std::min(limit * 8, config.oracleNodes);
+        }
+    }
+    return legal[pick(rng)];
+}
+
+int Simulator::solvable(Bitboard pegs, uint64_t& budget, TranspositionTable& oracle) {
+    if (popCount(pegs) == 1) {
+        return 1;
+    }
+
+    // A lost entry only costs solving it again
+    Bitboard key = shape.canonical(pegs);
+    int known;
+    if (oracle.probe(key, known)) {
+        return known;
+    }
+    if (budget == 0) {
+        return -1;
+    }
+    budget--;
+
+    bool unknown = false;
+    const std::vector<Jump>& jumps = shape.getJumps();
+    for (size_t id = 0; id < jumps.size(); id++) {
+        if (!canJump(pegs, jumps[id])) continue;
+
+        int result = solvable(applyJump(pegs, jumps[id]), budget, oracle);
+        if (result > 0) {
+            oracle.store(key, 1, popCount(pegs));
+            return 1;
+        }
+        unknown = unknown || result < 0;
+    }
+
+    // Only proven results are cached
+    if (unknown) {
+        return -1;
+    }
+    oracle.store(key, 0, popCount(pegs));
+    return 0;
+}
+
+bool Simulator::writeCsv(const std::string& path, const BoardShape& shape, const SimulationStats& stats) {
+    std::ofstream out(path.c_str());
+    if (!out.is_open()) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    // Long format: one row per value of each distribution
+    out << "metric,key,count\n";
+    out << "games,," << stats.games << "\n";
+    out << "wins,," << stats.wins << "\n";
+    for (size_t i = 0; i < stats.finalPegs.size(); i++) {
+        out << "final_pegs," << i << "," << stats.finalPegs[i] << "\n";
+    }
+    for (size_t i = 0; i < stats.lengths.size(); i++) {
+        out << "length," << i << "," << stats.lengths[i] << "\n";
+    }
+    for (Bitboard holes = shape.getHoles(); holes; holes &= holes - 1) {
+        Position pos = shape.position(lowestBit(holes));
+        out << "hole_end," << pos.row << ":" << pos.col << "," << stats.holeEnds[lowestBit(holes)] << "\n";
+    }
+    return out.good();
+}
+
+bool Simulator::writeJson(const std::string& path, const BoardShape& shape, const SimulationConfig& config,
+                          const SimulationStats& stats) {
+    std::ofstream out(path.c_str());
+    if (!out.is_open()) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    out << "{\n  \"board\": \"" << shape.getName() << "\",\n"
+        << "  \"policy\": \"" << policyName(config.policy) << "\",\n"
+        << "  \"seed\": " << config.seed << ",\n"
+        << "  \"games\": " << stats.games << ",\n"
+        << "  \"wins\": " << stats.wins << ",\n"
+        << "  \"seconds\": " << stats.seconds << ",\n";
+
+    out << "  \"final_pegs\": [";
+    for (size_t i = 0; i < stats.finalPegs.size(); i++) {
+        out << (i ? ", " : "") << stats.finalPegs[i];
+    }
+    out << "],\n  \"lengths\": [";
+    for (size_t i = 0; i < stats.lengths.size(); i++) {
+        out << (i ? ", " : "") << stats.lengths[i];
+    }
+    out << "],\n  \"hole_ends\": {";
+    bool first = true;
+    for (Bitboard holes = shape.getHoles(); holes; holes &= holes - 1) {
+        Position pos = shape.position(lowestBit(holes));
+        out << (first ? "" : ", ") << "\"" << pos.row << "," << pos.col << "\": " << stats.holeEnds[lowestBit(holes)];
+        first = false;
+    }
+    out << "}\n}\n";
+    return out.good();
+}
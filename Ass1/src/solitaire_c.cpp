@@ -0,0 +1,165 @@
+#include "solitaire_c.h"
+#include <memory>
+#include <new>
+
+#include "opening_book.h"
+#include "solvability.h"
+
+static_assert(SOLITAIRE_JUMP_WORDS * 64 >= 100, "room for every jump of the supported boards");
+
+struct solitaire_engine {
+    SolvabilityOracle oracle;
+    const BoardShape& shape;
+    std::unique_ptr<OpeningBook> book;
+
+    solitaire_engine(const BoardShape& boardShape, size_t tableMegabytes)
+        : oracle(boardShape, tableMegabytes), shape(oracle.getShape()) {}
+};
+
+int solitaire_api_version(void) {
+    return SOLITAIRE_API_VERSION;
+}
+
+solitaire_engine* solitaire_engine_create(int board, size_t table_megabytes) {
+    if (board != SOLITAIRE_ENGLISH && board != SOLITAIRE_FRENCH) {
+        return nullptr;
+    }
+    // No exception may cross into the caller's language
+    try {
+        return new solitaire_engine(board == SOLITAIRE_ENGLISH ? BoardShape::english() : BoardShape::french(),
+                                    table_megabytes);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void solitaire_engine_destroy(solitaire_engine* engine) {
+    delete engine;
+}
+
+int solitaire_engine_load_book(solitaire_engine* engine, const char* path) {
+    if (!engine || !path) {
+        return SOLITAIRE_ERROR_ARGUMENT;
+    }
+    try {
+        std::unique_ptr<OpeningBook> book(new OpeningBook(path));
+        if (!book->isOpen() || book->getShape().getName() != engine->shape.getName()) {
+            return SOLITAIRE_ERROR_ARGUMENT;
+        }
+        engine->oracle.setBook(book.get());
+        engine->book.swap(book);
+    } catch (const std::bad_alloc&) {
+        return SOLITAIRE_ERROR_MEMORY;
+    }
+    return 0;
+}
+
+int solitaire_board_size(const solitaire_engine* engine) {
+    return engine ? engine->shape.getSize() : SOLITAIRE_ERROR_ARGUMENT;
+}
+
+solitaire_board solitaire_holes(const solitaire_engine* engine) {
+    return engine ? engine->shape.getHoles() : 0;
+}
+
+solitaire_board solitaire_start(const solitaire_engine* engine) {
+    return engine ? engine->shape.startPosition() : 0;
+}
+
+int solitaire_jump_count(const solitaire_engine* engine) {
+    return engine ? static_cast<int>(engine->shape.getJumps().size()) : SOLITAIRE_ERROR_ARGUMENT;
+}
+
+int solitaire_jump(const solitaire_engine* engine, int jump, int* from, int* over, int* to) {
+    if (!engine || jump < 0 || jump >= static_cast<int>(engine->shape.getJumps().size())) {
+        return SOLITAIRE_ERROR_ARGUMENT;
+    }
+    const Jump& found = engine->shape.getJumps()[jump];
+    if (from) *from = found.from;
+    if (over) *over = found.over;
+    if (to) *to = found.to;
+    return 0;
+}
+
+int64_t solitaire_apply_jumps(const solitaire_engine* engine, solitaire_board* boards, const int32_t* jumps,
+                              size_t count, uint8_t* applied) {
+    if (!engine || ((!boards || !jumps) && count)) {
+        return SOLITAIRE_ERROR_ARGUMENT;
+    }
+
+    const std::vector<Jump>& all = engine->shape.getJumps();
+    int32_t jumpCount = static_cast<int32_t>(all.size());
+    int64_t made = 0;
+    for (size_t i = 0; i < count; i++) {
+        bool legal = jumps[i] >= 0 && jumps[i] < jumpCount && canJump(boards[i], all[jumps[i]]);
+        if (legal) {
+            boards[i] = applyJump(boards[i], all[jumps[i]]);
+            made++;
+        }
+        if (applied) applied[i] = legal;
+    }
+    return made;
+}
+
+int64_t solitaire_legal_jumps(const solitaire_engine* engine, const solitaire_board* boards, size_t count,
+                              uint64_t* masks, uint8_t* counts) {
+    if (!engine || (!boards && count)) {
+        return SOLITAIRE_ERROR_ARGUMENT;
+    }
+
+    const std::vector<Jump>& all = engine->shape.getJumps();
+    int64_t movable = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t words[SOLITAIRE_JUMP_WORDS] = {0};
+        int legal = 0;
+        for (size_t id = 0; id < all.size(); id++) {
+            if (canJump(boards[i], all[id])) {
+                words[id >> 6] |= uint64_t(1) << (id & 63);
+                legal++;
+            }
+        }
+        if (masks) {
+            for (int w = 0; w < SOLITAIRE_JUMP_WORDS; w++) {
+                masks[i * SOLITAIRE_JUMP_WORDS + w] = words[w];
+            }
+        }
+        if (counts) counts[i] = static_cast<uint8_t>(legal);
+        movable += legal > 0;
+    }
+    return movable;
+}
+
+int64_t solitaire_solvable(solitaire_engine* engine, const solitaire_board* boards, size_t count, uint8_t* results,
+                           int32_t* winning_jumps) {
+    if (!engine || ((!boards || !results) && count)) {
+        return SOLITAIRE_ERROR_ARGUMENT;
+    }
+
+    Bitboard holes = engine->shape.getHoles();
+    int64_t winnable = 0;
+    engine->oracle.newSearch();
+    for (size_t i = 0; i < count; i++) {
+        int jump = -1;
+        if (boards[i] == 0 || (boards[i] & ~holes)) {
+            results[i] = SOLITAIRE_INVALID;
+        } else if (popCount(boards[i]) == 1) {
+            results[i] = SOLITAIRE_WINNABLE;
+        } else {
+            jump = engine->oracle.winningJump(boards[i]);
+            results[i] = jump >= 0 ? SOLITAIRE_WINNABLE : SOLITAIRE_DEAD_END;
+        }
+        if (winning_jumps) winning_jumps[i] = jump;
+        winnable += results[i] == SOLITAIRE_WINNABLE;
+    }
+    return winnable;
+}
+
+int64_t solitaire_canonical(const solitaire_engine* engine, solitaire_board* boards, size_t count) {
+    if (!engine || (!boards && count)) {
+        return SOLITAIRE_ERROR_ARGUMENT;
+    }
+    for (size_t i = 0; i < count; i++) {
+        boards[i] = engine->shape.canonical(boards[i]);
+    }
+    return static_cast<int64_t>(count);
+}
@@ -0,0 +1,245 @@
+#include "solution_counter.h"
+#include "opening_book.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <thread>
+
+std::string formatCount(SolutionCount value) {
+    std::string digits;
+    do {
+        digits += static_cast<char>('0' + static_cast<int>(value % 10));
+        value /= 10;
+    } while (value);
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+bool parseCount(const std::string& text, SolutionCount& value) {
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    return !text.empty();
+}
+
+CountMemo::CountMemo(size_t megabytes) : partSize(1), locks(new std::mutex[PARTS]), count(0) {
+    // Round down to a power of two number of slots per part
+    size_t wanted = (megabytes << 20) / sizeof(Entry) / PARTS;
+    while (partSize * 2 <= wanted) {
+        partSize *= 2;
+    }
+    Entry empty = {0, 0, 0};
+    entries.assign(partSize * PARTS, empty);
+}
+
+size_t CountMemo::partOf(Bitboard key) const {
+    // The top bits of a Fibonacci hash pick the part
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 52) & (PARTS - 1);
+}
+
+bool CountMemo::find(Bitboard key, SolutionCount& value) const {
+    size_t part = partOf(key);
+    const Entry* slots = &entries[part * partSize];
+    size_t slot = static_cast<size_t>(key * 0xC2B2AE3D27D4EB4FULL >> 20) & (partSize - 1);
+
+    std::lock_guard<std::mutex> lock(locks[part]);
+    for (size_t probe = 0; probe < partSize; probe++) {
+        const Entry& entry = slots[(slot + probe) & (partSize - 1)];
+        if (entry.key == key) {
+            value = (SolutionCount(entry.high) << 64) | entry.low;
+            return true;
+        }
+        if (entry.key == 0) break;
+    }
+    return false;
+}
+
+bool CountMemo::insert(Bitboard key, SolutionCount value) {
+    size_t part = partOf(key);
+    Entry* slots = &entries[part * partSize];
+    size_t slot = static_cast<size_t>(key * 0xC2B2AE3D27D4EB4FULL >> 20) & (partSize - 1);
+
+    std::lock_guard<std::mutex> lock(locks[part]);
+    for (size_t probe = 0; probe < partSize; probe++) {
+        Entry& entry = slots[(slot + probe) & (partSize - 1)];
+        if (entry.key == key) {
+            return true;   // Another thread counted it first; the value is the same
+        }
+        if (entry.key == 0) {
+            entry.key = key;
+            entry.low = static_cast<uint64_t>(value);
+            entry.high = static_cast<uint64_t>(value >> 64);
+            count++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CountMemo::clear() {
+    Entry empty = {0, 0, 0};
+    std::fill(entries.begin(), entries.end(), empty);
+    count = 0;
+}
+
+bool CountMemo::save(const std::string& path, const BoardShape& shape) const {
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    uint32_t version = 1;
+    uint32_t size = shape.getSize();
+    Bitboard holes = shape.getHoles();
+    uint64_t stored = count.load();
+    std::fwrite("MSCM", 1, 4, file);
+    std::fwrite(&version, sizeof(version), 1, file);
+    std::fwrite(&size, sizeof(size), 1, file);
+    std::fwrite(&holes, sizeof(holes), 1, file);
+    std::fwrite(&stored, sizeof(stored), 1, file);
+    for (const Entry& entry : entries) {
+        if (entry.key) {
+            std::fwrite(&entry, sizeof(entry), 1, file);
+        }
+    }
+
+    bool ok = std::ferror(file) == 0;
+    ok = std::fclose(file) == 0 && ok;
+    return ok && std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool CountMemo::load(const std::string& path, const BoardShape& shape) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0, size = 0;
+    Bitboard holes = 0;
+    uint64_t stored = 0;
+    bool ok = std::fread(magic, 1, 4, file) == 4 && std::equal(magic, magic + 4, "MSCM") &&
+              std::fread(&version, sizeof(version), 1, file) == 1 && version == 1 &&
+              std::fread(&size, sizeof(size), 1, file) == 1 &&
+              std::fread(&holes, sizeof(holes), 1, file) == 1 &&
+              std::fread(&stored, sizeof(stored), 1, file) == 1;
+    if (!ok || static_cast<int>(size) != shape.getSize() || holes != shape.getHoles()) {
+        std::cerr << path << " is not a memo file for the " << shape.getName() << " board" << std::endl;
+        std::fclose(file);
+        return false;
+    }
+
+    Entry entry;
+    uint64_t loaded = 0;
+    while (loaded < stored && std::fread(&entry, sizeof(entry), 1, file) == 1) {
+        if (!insert(entry.key, (SolutionCount(entry.high) << 64) | entry.low)) {
+            std::cerr << "Memo table too small for " << path << std::endl;
+            break;
+        }
+        loaded++;
+    }
+    std::fclose(file);
+    return loaded == stored;
+}
+
+SolutionCounter::SolutionCounter(const BoardShape& boardShape, size_t memoMegabytes)
+    : shape(boardShape), memo(memoMegabytes), nodes(0), memoFull(false), book(nullptr), bookMinPegs(0) {
+}
+
+void SolutionCounter::setBook(const OpeningBook* openingBook) {
+    book = openingBook && openingBook->hasCounts() ? openingBook : nullptr;
+    bookMinPegs = book ? popCount(book->getStart()) - book->getPlies() : 0;
+}
+
+SolutionCount SolutionCounter::count(Bitboard pegs) {
+    uint64_t expanded = 0;
+    SolutionCount total = countFrom(pegs, expanded);
+    nodes += expanded;
+    return total;
+}
+
+SolutionCount SolutionCounter::countFrom(Bitboard pegs, uint64_t& expanded) {
+    if (popCount(pegs) == 1) {
+        return 1;
+    }
+
+    // Deeper positions cannot be in the book: skip the lookup
+    OpeningBookHit hit;
+    if (book && popCount(pegs) >= bookMinPegs && book->lookup(pegs, hit)) {
+        return hit.solutions;
+    }
+
+    Bitboard key = shape.canonical(pegs);
+    SolutionCount total = 0;
+    if (memo.find(key, total)) {
+        return total;
+    }
+
+    expanded++;
+    const std::vector<Jump>& jumps = shape.getJumps();
+    for (size_t id = 0; id < jumps.size(); id++) {
+        if (canJump(pegs, jumps[id])) {
+            total += countFrom(applyJump(pegs, jumps[id]), expanded);
+        }
+    }
+
+    // A full memo only costs speed: the count is still exact
+    if (!memo.insert(key, total) && !memoFull.exchange(true)) {
+        std::cerr << "Memo table is full, counting continues much slower without it" << std::endl;
+    }
+    return total;
+}
+
+SolutionCount SolutionCounter::countParallel(Bitboard pegs, int threads, int splitDepth) {
+    if (threads <= 1) {
+        return count(pegs);
+    }
+
+    // Positions splitDepth jumps in, each with the number of jump sequences
+    // reaching it. Finished games stay in the frontier as they are.
+    std::map<Bitboard, SolutionCount> frontier;
+    frontier[shape.canonical(pegs)] = 1;
+    for (int depth = 0; depth < splitDepth; depth++) {
+        std::map<Bitboard, SolutionCount> next;
+        for (const auto& entry : frontier) {
+            bool moved = false;
+            for (const Jump& jump : shape.getJumps()) {
+                if (canJump(entry.first, jump)) {
+                    next[shape.canonical(applyJump(entry.first, jump))] += entry.second;
+                    moved = true;
+                }
+            }
+            if (!moved) {
+                next[entry.first] += entry.second;
+            }
+        }
+        frontier.swap(next);
+    }
+
+    std::vector<std::pair<Bitboard, SolutionCount> > work(frontier.begin(), frontier.end());
+    std::atomic<size_t> nextIndex(0);
+    std::vector<SolutionCount> partial(threads, 0);
+    std::vector<uint64_t> expanded(threads, 0);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&, t]() {
+            for (size_t i = nextIndex++; i < work.size(); i = nextIndex++) {
+                partial[t] += work[i].second * countFrom(work[i].first, expanded[t]);
+            }
+        }));
+    }
+
+    SolutionCount total = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t].join();
+        total += partial[t];
+        nodes += expanded[t];
+    }
+    return total;
+}
@@ -0,0 +1,42 @@
+#include "solvability.h"
+#include "opening_book.h"
+
+SolvabilityOracle::SolvabilityOracle(const BoardShape& boardShape, size_t tableMegabytes)
+    : shape(boardShape), table(tableMegabytes), book(nullptr) {
+}
+
+bool SolvabilityOracle::solvable(Bitboard pegs) {
+    if (popCount(pegs) == 1) {
+        return true;
+    }
+
+    OpeningBookHit hit;
+    if (book && book->lookup(pegs, hit)) {
+        return hit.solvable;
+    }
+
+    Bitboard key = shape.canonical(pegs);
+    int known;
+    if (table.probe(key, known)) {
+        return known != 0;
+    }
+
+    bool result = winningJump(pegs) >= 0;
+    table.store(key, result ? 1 : 0, popCount(pegs));
+    return result;
+}
+
+int SolvabilityOracle::winningJump(Bitboard pegs) {
+    OpeningBookHit hit;
+    if (book && book->lookup(pegs, hit)) {
+        return hit.bestJump;
+    }
+
+    const std::vector<Jump>& jumps = shape.getJumps();
+    for (size_t id = 0; id < jumps.size(); id++) {
+        if (canJump(pegs, jumps[id]) && solvable(applyJump(pegs, jumps[id]))) {
+            return static_cast<int>(id);
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,159 @@
+#include "spectator_wall.h"
+#include <algorithm>
+
+SpectatorWall::SpectatorWall(const BoardShape& boardShape, Bitboard start, const WallConfig& wallConfig)
+    : shape(boardShape), startPegs(start), config(wallConfig), simulator(boardShape), front(0), published(0),
+      arrived(0), tick(0), running(false), games(0), wins(0) {
+    config.boards = std::max(config.boards, 1);
+    policy.policy = config.policy == POLICY_GREEDY_MOBILITY ? POLICY_GREEDY_MOBILITY : POLICY_RANDOM;
+    policy.seed = config.seed;
+
+    WallBoard initial = WallBoard();
+    initial.pegs = startPegs;
+    buffers[0].assign(config.boards, initial);
+    buffers[1].assign(config.boards, initial);
+}
+
+SpectatorWall::~SpectatorWall() {
+    stop();
+}
+
+void SpectatorWall::start() {
+    if (running) return;
+
+    int threads = config.threads;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    }
+    threads = std::max(1, std::min(threads, config.boards));
+
+    running = true;
+    arrived = 0;
+    epoch = std::chrono::steady_clock::now();
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(std::thread(&SpectatorWall::worker, this, i, threads));
+    }
+}
+
+void SpectatorWall::stop() {
+    {
+        std::lock_guard<std::mutex> lock(tickMutex);
+        running = false;
+    }
+    tickDone.notify_all();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    workers.clear();
+}
+
+bool SpectatorWall::latest(std::vector<WallBoard>& out, uint64_t& sequence) const {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    if (published == sequence && !out.empty()) {
+        return false;
+    }
+    out = buffers[front];
+    sequence = published;
+    return true;
+}
+
+WallStats SpectatorWall::getStats() const {
+    WallStats stats;
+    {
+        std::lock_guard<std::mutex> lock(publishMutex);
+        stats.ticks = published;
+    }
+    stats.games = games.load(std::memory_order_relaxed);
+    stats.wins = wins.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SpectatorWall::worker(int index, int threads) {
+    // Fixed slices and one stream per thread, as in Simulator
+    int begin = static_cast<int>(static_cast<int64_t>(config.boards) * index / threads);
+    int end = static_cast<int>(static_cast<int64_t>(config.boards) * (index + 1) / threads);
+    std::seed_seq seeds{static_cast<uint32_t>(config.seed), static_cast<uint32_t>(config.seed >> 32),
+                        static_cast<uint32_t>(index)};
+    std::mt19937_64 rng(seeds);
+
+    // The live games stay private to the thread; only copies reach the snapshot
+    std::vector<WallBoard> boards(end - begin);
+    std::vector<int> hold(end - begin, 0);
+    for (WallBoard& board : boards) {
+        board = WallBoard();
+        board.pegs = startPegs;
+    }
+
+    const std::vector<Jump>& jumps = shape.getJumps();
+    int legal[256];
+    bool winnable = true;
+    int back;
+    {
+        // No flip can happen before every worker, this one included, finishes a tick
+        std::lock_guard<std::mutex> lock(publishMutex);
+        back = 1 - front;
+    }
+    uint64_t ticks = 0;
+    while (running) {
+        for (size_t i = 0; i < boards.size(); i++) {
+            WallBoard& board = boards[i];
+            if (board.state != WALL_PLAYING) {
+                if (--hold[i] <= 0) {
+                    board = WallBoard();
+                    board.pegs = startPegs;
+                }
+            } else {
+                int count = 0;
+                for (size_t id = 0; id < jumps.size() && count < 256; id++) {
+                    if (canJump(board.pegs, jumps[id])) {
+                        legal[count++] = static_cast<int>(id);
+                    }
+                }
+                if (count == 0) {
+                    bool won = popCount(board.pegs) == 1;
+                    board.state = won ? WALL_WON : WALL_LOST;
+                    hold[i] = config.holdTicks;
+                    games.fetch_add(1, std::memory_order_relaxed);
+                    wins.fetch_add(won, std::memory_order_relaxed);
+                } else {
+                    int id = simulator.chooseJump(board.pegs, legal, count, policy, rng, winnable, nullptr, nullptr);
+                    board.pegs = applyJump(board.pegs, jumps[id]);
+                    board.jumps++;
+                }
+            }
+            buffers[back][begin + i] = board;
+        }
+
+        if (!finishTick(threads)) {
+            break;
+        }
+        back = 1 - back;
+        ticks++;
+
+        // Paced from a shared epoch, so a slow tick does not push back the ones after it
+        if (config.tickMilliseconds > 0) {
+            std::this_thread::sleep_until(epoch + std::chrono::milliseconds(
+                static_cast<int64_t>(config.tickMilliseconds) * static_cast<int64_t>(ticks)));
+        }
+    }
+}
+
+bool SpectatorWall::finishTick(int threads) {
+    std::unique_lock<std::mutex> lock(tickMutex);
+    uint64_t mine = tick;
+    if (++arrived == threads) {
+        {
+            // The back buffer is complete: it becomes what readers copy
+            std::lock_guard<std::mutex> publish(publishMutex);
+            front = 1 - front;
+            published++;
+        }
+        arrived = 0;
+        tick++;
+        lock.unlock();
+        tickDone.notify_all();
+        return running;
+    }
+    tickDone.wait(lock, [&] { return tick != mine || !running; });
+    return running;
+}
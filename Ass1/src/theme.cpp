@@ -1,4 +1,130 @@
 #include "theme.h"
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <glm/gtc/matrix_transform.hpp>
 
 // Initialize the global theme with default values
-Theme currentTheme;
\ No newline at end of file
+Theme currentTheme;
+
+ThemeUniforms Theme::uniforms() const {
+    ThemeUniforms block;
+    block.projection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f);
+    block.backgroundColor = BACKGROUND_COLOR;
+    block.boardColor = BOARD_COLOR;
+    block.marbleColor = MARBLE_COLOR;
+    block.selectionColor = selectionColor();
+    block.hintColor = hintColor();
+    block.winnableColor = WINNABLE_COLOR;
+    block.deadColor = DEAD_COLOR;
+    block.pendingColor = PENDING_COLOR;
+    block.placement = glm::vec4(BOARD_ORIGIN_X, BOARD_ORIGIN_Y, BOARD_WIDTH, 0.0f);
+    block.scales = glm::vec4(CELL_SCALE_FACTOR, MARBLE_SCALE_FACTOR, OVERLAY_SCALE_FACTOR, MARBLE_Z_POSITION);
+    return block;
+}
+
+bool Theme::loadFromFile(const std::string& path, Theme& theme, std::string& error) {
+    std::ifstream in(path.c_str());
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    struct Field {
+        const char* key;
+        float* values;
+        int count;          // Colours may leave out alpha, which stays 1
+    };
+    const Field fields[] = {
+        {"background", &theme.BACKGROUND_COLOR[0], 4},
+        {"board", &theme.BOARD_COLOR[0], 4},
+        {"marble", &theme.MARBLE_COLOR[0], 4},
+        {"highlight", &theme.HIGHLIGHT_COLOR[0], 4},
+        {"text", &theme.TEXT_COLOR[0], 4},
+        {"winnable", &theme.WINNABLE_COLOR[0], 4},
+        {"dead", &theme.DEAD_COLOR[0], 4},
+        {"pending", &theme.PENDING_COLOR[0], 4},
+        {"cell_scale", &theme.CELL_SCALE_FACTOR, 1},
+        {"marble_scale", &theme.MARBLE_SCALE_FACTOR, 1},
+        {"marble_depth", &theme.MARBLE_Z_POSITION, 1},
+        {"overlay_scale", &theme.OVERLAY_SCALE_FACTOR, 1},
+    };
+
+    std::string line;
+    for (int number = 1; std::getline(in, line); number++) {
+        line = line.substr(0, line.find('#'));
+        size_t equals = line.find('=');
+        std::istringstream keyStream(line.substr(0, equals));
+        std::string key;
+        if (!(keyStream >> key)) continue;
+
+        std::ostringstream where;
+        where << path << ":" << number << ": ";
+        if (equals == std::string::npos) {
+            error = where.str() + "expected key = value";
+            return false;
+        }
+        std::string value = line.substr(equals + 1);
+        size_t first = value.find_first_not_of(" \t\r");
+        size_t last = value.find_last_not_of(" \t\r");
+        value = first == std::string::npos ? "" : value.substr(first, last - first + 1);
+
+        if (key == "name") {
+            theme.NAME = value;
+            continue;
+        }
+        if (key == "description") {
+            theme.DESCRIPTION = value;
+            continue;
+        }
+
+        const Field* field = nullptr;
+        for (const Field& candidate : fields) {
+            if (key == candidate.key) field = &candidate;
+        }
+        if (!field) {
+            error = where.str() + "unknown key '" + key + "'";
+            return false;
+        }
+
+        std::istringstream numbers(value);
+        float parsed[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        int count = 0;
+        while (count < 4 && numbers >> parsed[count]) count++;
+        bool valid = field->count == 1 ? count == 1 : count == 3 || count == 4;
+        if (!valid || !numbers.eof()) {
+            error = where.str() + "'" + key + (field->count == 1 ? "' takes one number" : "' takes 3 or 4 numbers");
+            return false;
+        }
+        std::copy(parsed, parsed + field->count, field->values);
+    }
+    return true;
+}
+
+std::vector<Theme> Theme::loadDirectory(const std::string& directory) {
+    std::vector<std::string> files;
+    if (DIR* dir = opendir(directory.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() > 6 && name.compare(name.size() - 6, 6, ".theme") == 0) {
+                files.push_back(name);
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<Theme> themes;
+    for (const std::string& file : files) {
+        Theme theme;
+        std::string error;
+        if (loadFromFile(directory + "/" + file, theme, error)) {
+            themes.push_back(theme);
+        } else {
+            std::cerr << "Skipping theme: " << error << std::endl;
+        }
+    }
+    return themes;
+}
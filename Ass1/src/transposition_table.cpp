@@ -0,0 +1,162 @@
+#include "transposition_table.h"
+#include <iostream>
+#include <sys/mman.h>
+
+TranspositionTable::TranspositionTable(size_t megabytes, ReplacementPolicy replacement, bool hugePages)
+    : buckets(nullptr), bucketCount(1), shift(64), policy(replacement), hugePagesActive(false),
+      probes(0), hits(0), stores(0), collisions(0) {
+    generation.store(0, std::memory_order_relaxed);
+
+    // Round the budget down to a power of two number of buckets
+    size_t wanted = (megabytes << 20) / sizeof(Bucket);
+    while (bucketCount * 2 <= wanted) {
+        bucketCount *= 2;
+        shift--;
+    }
+
+    // Anonymous mappings come back zeroed, which is exactly an empty table
+    size_t bytes = getBytes();
+    void* memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (hugePages) {
+        memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        hugePagesActive = memory != MAP_FAILED;
+    }
+#endif
+    if (memory == MAP_FAILED) {
+        memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+        // No reserved huge pages: ask for transparent ones instead
+        if (hugePages && memory != MAP_FAILED) {
+            hugePagesActive = madvise(memory, bytes, MADV_HUGEPAGE) == 0;
+        }
+#endif
+    }
+    if (memory == MAP_FAILED) {
+        std::cerr << "Failed to allocate a " << (bytes >> 20) << " MB transposition table" << std::endl;
+        bucketCount = 0;
+        return;
+    }
+    buckets = static_cast<Bucket*>(memory);
+}
+
+TranspositionTable::~TranspositionTable() {
+    if (buckets) {
+        munmap(buckets, getBytes());
+    }
+}
+
+uint64_t TranspositionTable::pack(int value, int depth, int gen) {
+    return uint64_t(uint32_t(value)) | (uint64_t(depth & 0xFFFF) << 32) | (uint64_t(gen) << 48);
+}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(Bitboard key) const {
+    // Fibonacci hashing: the top bits of the product are well mixed
+    size_t index = shift >= 64 ? 0 : static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift);
+    return buckets[index];
+}
+
+bool TranspositionTable::probe(Bitboard key, int& value) {
+    if (!bucketCount) return false;
+    probes.fetch_add(1, std::memory_order_relaxed);
+
+    Bucket& bucket = bucketFor(key);
+    int current = generation.load(std::memory_order_relaxed) & 0xFF;
+    for (int i = 0; i < SLOTS_PER_BUCKET; i++) {
+        Slot& slot = bucket.slots[i];
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key) {
+            value = static_cast<int32_t>(data & 0xFFFFFFFFu);
+            hits.fetch_add(1, std::memory_order_relaxed);
+            if (static_cast<int>(data >> 48) != current) {
+                // Still in use: it joins the current search rather than being replaced first
+                uint64_t refreshed = (data & ~(uint64_t(0xFF) << 48)) | (uint64_t(current) << 48);
+                slot.check.store(key ^ refreshed, std::memory_order_relaxed);
+                slot.data.store(refreshed, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(Bitboard key, int value, int depth) {
+    if (!bucketCount) return;
+    stores.fetch_add(1, std::memory_order_relaxed);
+
+    Bucket& bucket = bucketFor(key);
+    int current = generation.load(std::memory_order_relaxed) & 0xFF;
+    // Always-replace evicts the slot picked by the hash bits just below the
+    // bucket index, so every slot of a full bucket takes its share
+    int preferred = static_cast<int>(((key * 0x9E3779B97F4A7C15ULL) >> (shift - 2)) & (SLOTS_PER_BUCKET - 1));
+    int victim = -1;
+    int victimScore = 1 << 30;
+    for (int i = 0; i < SLOTS_PER_BUCKET; i++) {
+        uint64_t data = bucket.slots[i].data.load(std::memory_order_relaxed);
+        Bitboard slotKey = bucket.slots[i].check.load(std::memory_order_relaxed) ^ data;
+
+        if (slotKey == key || slotKey == 0) {
+            // Same position, or a free slot: no need to evict anything
+            victim = i;
+            break;
+        }
+
+        // Entries from earlier searches are worth less than anything current
+        int slotDepth = static_cast<int>((data >> 32) & 0xFFFF);
+        bool stale = static_cast<int>(data >> 48) != current;
+        int score = policy == REPLACE_ALWAYS ? (i - preferred) & (SLOTS_PER_BUCKET - 1)
+                                             : slotDepth - (stale ? 0x10000 : 0);
+        if (score < victimScore) {
+            victimScore = score;
+            victim = i;
+        }
+    }
+
+    Slot& slot = bucket.slots[victim];
+    uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+    Bitboard oldKey = slot.check.load(std::memory_order_relaxed) ^ oldData;
+    if (oldKey != 0 && oldKey != key) {
+        if (policy == REPLACE_DEPTH_PREFERRED && victimScore > depth) {
+            // Everything here is deeper and current: keep it
+            return;
+        }
+        collisions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t data = pack(value, depth, current);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (size_t b = 0; b < bucketCount; b++) {
+        for (int i = 0; i < SLOTS_PER_BUCKET; i++) {
+            buckets[b].slots[i].check.store(0, std::memory_order_relaxed);
+            buckets[b].slots[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+    probes = hits = stores = collisions = 0;
+}
+
+TranspositionStats TranspositionTable::getStats() const {
+    TranspositionStats stats;
+    stats.probes = probes.load();
+    stats.hits = hits.load();
+    stats.stores = stores.load();
+    stats.collisions = collisions.load();
+    stats.capacity = getCapacity();
+
+    // Sample at most a million slots; exact for small tables
+    size_t step = bucketCount > (1 << 18) ? bucketCount / (1 << 18) : 1;
+    uint64_t sampled = 0, used = 0;
+    for (size_t b = 0; b < bucketCount; b += step) {
+        for (int i = 0; i < SLOTS_PER_BUCKET; i++) {
+            uint64_t data = buckets[b].slots[i].data.load(std::memory_order_relaxed);
+            used += (buckets[b].slots[i].check.load(std::memory_order_relaxed) ^ data) != 0;
+            sampled++;
+        }
+    }
+    stats.occupied = sampled ? static_cast<uint64_t>(double(used) / sampled * stats.capacity) : 0;
+    return stats;
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <string>
+#include <unistd.h>
+#include <unordered_set>
+#include <vector>
+
+#include "external_bfs.h"
+
+// Enumerates a small English position on disk with a budget so tight that
+// each layer's runs take two intermediate merge passes, and checks every
+// layer against an in-memory breadth-first search.
+
+namespace {
+
+const size_t IO_BUFFER = 4096;
+const size_t MEMORY = 3 * IO_BUFFER;   // Fan-in 2, 1024 boards per run
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::printf("%-4s %s\n", ok ? "ok" : "FAIL", what.c_str());
+    failures += !ok;
+}
+
+} // namespace
+
+int main() {
+    BoardShape shape = BoardShape::english();
+    // The start without its top and left arms: 20 marbles, big enough layers
+    // to need many runs, small enough to enumerate in a moment
+    Bitboard start = shape.startPosition();
+    for (int row = 0; row < 2; row++) {
+        for (int col = 2; col < 5; col++) {
+            start &= ~(Bitboard(1) << shape.index(row, col));
+            start &= ~(Bitboard(1) << shape.index(col, row));
+        }
+    }
+
+    // Expected layers, and the most successors any layer produces
+    std::vector<uint64_t> expected(popCount(start) + 1, 0);
+    size_t mostSuccessors = 0;
+    std::vector<Bitboard> layer(1, start);
+    for (int pegs = popCount(start); !layer.empty(); pegs--) {
+        expected[pegs] = layer.size();
+        std::unordered_set<Bitboard> next;
+        size_t successors = 0;
+        for (Bitboard board : layer) {
+            for (const Jump& jump : shape.getJumps()) {
+                if (canJump(board, jump)) {
+                    next.insert(applyJump(board, jump));
+                    successors++;
+                }
+            }
+        }
+        mostSuccessors = std::max(mostSuccessors, successors);
+        layer.assign(next.begin(), next.end());
+    }
+    // More than fanIn^2 runs need two passes before the final merge
+    check(mostSuccessors > 5 * 1024, "a layer has " + std::to_string(mostSuccessors) +
+                                         " successors, enough for two merge levels");
+
+    char directory[] = "/tmp/external_bfs_test.XXXXXX";
+    if (!mkdtemp(directory)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    ExternalBfsConfig config;
+    config.directory = directory;
+    config.memoryBytes = MEMORY;
+    config.ioBufferBytes = IO_BUFFER;
+    config.useSymmetry = false;
+    ExternalBfs bfs(shape, config);
+    check(bfs.run(start), "enumeration finishes");
+
+    const std::vector<uint64_t>& counts = bfs.getLayerCounts();
+    bool same = counts.size() == expected.size();
+    for (size_t pegs = 0; same && pegs < counts.size(); pegs++) {
+        same = counts[pegs] == expected[pegs];
+    }
+    check(same, "layer counts match the in-memory search");
+
+    // Only the layers and the checkpoint are left: every run and pass file is gone
+    int leftovers = 0;
+    if (DIR* listing = opendir(directory)) {
+        while (dirent* entry = readdir(listing)) {
+            std::string name = entry->d_name;
+            bool layer = name.size() > 4 && name.compare(name.size() - 4, 4, ".dat") == 0;
+            bool kept = name == "." || name == ".." || name == "checkpoint.txt" || layer;
+            leftovers += !kept;
+            std::remove((std::string(directory) + "/" + name).c_str());
+        }
+        closedir(listing);
+    }
+    rmdir(directory);
+    check(leftovers == 0, "no run or pass files are left behind");
+
+    std::printf("%s\n", failures ? "External BFS test FAILED" : "External BFS test passed");
+    return failures ? 1 : 0;
+}
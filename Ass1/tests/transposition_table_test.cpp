@@ -0,0 +1,70 @@
+#include <cstdio>
+#include <string>
+
+#include "transposition_table.h"
+
+// Replacement in a table of a single bucket: always-replace must spread its
+// evictions over every slot, and depth-preferred must keep deep entries of
+// the current search while stale ones go first.
+
+namespace {
+
+const int SLOTS = 4;   // TranspositionTable::SLOTS_PER_BUCKET
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    std::printf("%-4s %s\n", ok ? "ok" : "FAIL", what.c_str());
+    failures += !ok;
+}
+
+} // namespace
+
+int main() {
+    int value;
+
+    {
+        TranspositionTable table(0, REPLACE_ALWAYS);   // Rounds down to one bucket
+        check(table.getCapacity() == SLOTS, "a zero budget gives one bucket");
+
+        for (int key = 1; key <= SLOTS; key++) {
+            table.store(key, key);
+        }
+        int kept = 0;
+        for (int key = 1; key <= SLOTS; key++) {
+            kept += table.probe(key, value) && value == key;
+        }
+        check(kept == SLOTS, "a bucket holds " + std::to_string(SLOTS) + " positions");
+
+        // Enough new positions that each slot is picked many times over
+        for (int key = SLOTS + 1; key <= 100; key++) {
+            table.store(key, key);
+        }
+        int survivors = 0;
+        for (int key = 1; key <= SLOTS; key++) {
+            survivors += table.probe(key, value);
+        }
+        check(survivors == 0, "always-replace evicted every slot of the full bucket (" +
+                                  std::to_string(survivors) + " originals left)");
+        check(table.probe(100, value) && value == 100, "the newest position is found");
+    }
+
+    {
+        TranspositionTable table(0, REPLACE_DEPTH_PREFERRED);
+        for (int key = 1; key <= SLOTS; key++) {
+            table.store(key, key, 10);
+        }
+        table.store(SLOTS + 1, 0, 1);
+        int kept = 0;
+        for (int key = 1; key <= SLOTS; key++) {
+            kept += table.probe(key, value);
+        }
+        check(kept == SLOTS && !table.probe(SLOTS + 1, value), "depth-preferred keeps deeper current entries");
+
+        table.newSearch();
+        table.store(SLOTS + 1, 0, 1);
+        check(table.probe(SLOTS + 1, value), "a stale entry gives way to the new search");
+    }
+
+    std::printf("%s\n", failures ? "Transposition table test FAILED" : "Transposition table test passed");
+    return failures ? 1 : 0;
+}
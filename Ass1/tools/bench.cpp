@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "animator.h"
+#include "board_layout.h"
+#include "game.h"
+#include "theme.h"
+
+// Micro-benchmarks for the game engine and the CPU side of the renderer.
+// Every benchmark runs a batch of operations sized to a minimum time, over
+// warmup and measured repetitions; the summary is in nanoseconds per
+// operation, so runs before and after a change can be diffed directly.
+
+namespace {
+
+// The engine reports every move on std::cout; that output is discarded while
+// measuring, but still formatted, since the game pays for it too
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) { return c; }
+};
+
+struct Fixture {
+    MarbleSolitaire game;        // Mid-game board every benchmark starts from
+    MarbleSolitaire scratch;     // For benchmarks that change the board
+    MarbleSolitaire animated;    // Records move events for the animator
+    std::vector<Move> candidates; // Every on-board cell with each jump direction
+    std::vector<Move> legal;      // The candidates that are legal jumps
+    std::vector<Position> marbles;
+    Theme theme;
+    BoardLayout layout;
+    Animator animator;
+
+    explicit Fixture(int openingMoves);
+    void collect();
+};
+
+Fixture::Fixture(int openingMoves) : game(7), scratch(7), animated(7), theme(Theme::classicWood()) {
+    animated.setRecordMoveEvents(true);
+    // A fixed sequence of random legal jumps, so every run measures the same board
+    std::mt19937 rng(1);
+    for (int i = 0; i < openingMoves; i++) {
+        collect();
+        if (legal.empty()) break;
+        const Move& move = legal[std::uniform_int_distribution<size_t>(0, legal.size() - 1)(rng)];
+        game.makeMove(move.from, move.to);
+    }
+    collect();
+}
+
+void Fixture::collect() {
+    const int dr[] = {-2, 2, 0, 0};
+    const int dc[] = {0, 0, -2, 2};
+    candidates.clear();
+    legal.clear();
+    marbles.clear();
+    for (int row = 0; row < game.getBoardSize(); row++) {
+        for (int col = 0; col < game.getBoardSize(); col++) {
+            if (!game.isValidPosition(row, col)) continue;
+            if (game.getCell(row, col) == MARBLE) marbles.push_back(Position(row, col));
+            for (int i = 0; i < 4; i++) {
+                Move move(Position(row, col), Position(row + dr[i], col + dc[i]));
+                candidates.push_back(move);
+                if (game.isValidMove(move.from, move.to)) legal.push_back(move);
+            }
+        }
+    }
+}
+
+// Each benchmark performs `ops` operations and returns a checksum, so the
+// compiler cannot drop the work
+typedef uint64_t (*BenchFunction)(Fixture& fixture, uint64_t ops);
+
+uint64_t benchIsValidMove(Fixture& f, uint64_t ops) {
+    uint64_t valid = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        const Move& move = f.candidates[i % f.candidates.size()];
+        valid += f.game.isValidMove(move.from, move.to);
+    }
+    return valid;
+}
+
+uint64_t benchGameOver(Fixture& f, uint64_t ops) {
+    uint64_t over = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        over += f.game.gameOver();
+    }
+    return over;
+}
+
+uint64_t benchHasValidMovesFrom(Fixture& f, uint64_t ops) {
+    uint64_t movable = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        const Position& pos = f.marbles[i % f.marbles.size()];
+        movable += f.game.hasValidMovesFrom(pos.row, pos.col);
+    }
+    return movable;
+}
+
+uint64_t benchMakeUndo(Fixture& f, uint64_t ops) {
+    uint64_t made = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        const Move& move = f.legal[i % f.legal.size()];
+        made += f.game.makeMove(move.from, move.to);
+        made += f.game.undoMove();
+    }
+    return made;
+}
+
+uint64_t benchValidMovesForSelected(Fixture& f, uint64_t ops) {
+    uint64_t targets = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        const Position& pos = f.marbles[i % f.marbles.size()];
+        f.game.selectPosition(pos.row, pos.col);
+        targets += f.game.getValidMovesForSelected().size();
+    }
+    f.game.selectPosition(-1, -1);
+    return targets;
+}
+
+uint64_t benchReset(Fixture& f, uint64_t ops) {
+    for (uint64_t i = 0; i < ops; i++) {
+        f.scratch.reset();
+    }
+    return f.scratch.getRemainingMarbles();
+}
+
+uint64_t benchLayoutCells(Fixture& f, uint64_t ops) {
+    uint64_t quads = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        f.layout.buildCells(f.game, f.theme);
+        quads += f.layout.getCells().size();
+    }
+    return quads;
+}
+
+uint64_t benchLayoutMarbles(Fixture& f, uint64_t ops) {
+    uint64_t quads = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        f.layout.buildMarbles(f.game, f.theme);
+        quads += f.layout.getMarbles().size();
+    }
+    return quads;
+}
+
+uint64_t benchLayoutTexels(Fixture& f, uint64_t ops) {
+    uint64_t dirty = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        f.layout.buildTexels(f.game, Move());
+        dirty += f.layout.getDirtyTexels().width;
+    }
+    return dirty;
+}
+
+uint64_t benchAnimationFrame(Fixture& f, uint64_t ops) {
+    // One frame at 60 Hz with a jump in flight; once it lands it is undone, then played again
+    uint64_t instances = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        if (!f.animator.isActive()) {
+            if (!f.animated.undoMove()) f.animated.makeMove(1, 3, 3, 3);
+            f.animator.consume(f.animated);
+        }
+        f.animator.advance(1.0 / 60.0);
+        f.animator.buildInstances(f.animated, f.theme);
+        instances += f.animator.getInstances().size();
+    }
+    return instances;
+}
+
+struct Benchmark {
+    const char* name;
+    BenchFunction run;
+    const char* help;
+};
+
+const Benchmark BENCHMARKS[] = {
+    {"is_valid_move", benchIsValidMove, "isValidMove over every cell and direction"},
+    {"game_over", benchGameOver, "gameOver, a full hasValidMoves scan"},
+    {"has_valid_moves_from", benchHasValidMovesFrom, "hasValidMovesFrom for each marble"},
+    {"make_undo", benchMakeUndo, "makeMove + undoMove of each legal jump"},
+    {"valid_moves_for_selected", benchValidMovesForSelected, "selectPosition + getValidMovesForSelected"},
+    {"reset", benchReset, "reset to the starting board"},
+    {"layout_cells", benchLayoutCells, "board cell matrices and colours (renderBoard without GL)"},
+    {"layout_marbles", benchLayoutMarbles, "marble matrices and colours (renderMarbles without GL)"},
+    {"layout_texels", benchLayoutTexels, "board texels and their dirty rectangle (textured board without GL)"},
+    {"animation_frame", benchAnimationFrame, "fixed-step advance and instances of a jump in flight"},
+};
+
+struct Summary {
+    std::string name;
+    uint64_t ops;
+    std::vector<double> samples;   // Nanoseconds per operation, one per repetition
+    double min, median, mean, stddev, max;
+};
+
+double timeBatch(const Benchmark& bench, Fixture& fixture, uint64_t ops, uint64_t& sink) {
+    auto start = std::chrono::steady_clock::now();
+    sink += bench.run(fixture, ops);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Summary measure(const Benchmark& bench, Fixture& fixture, int warmup, int repetitions, double minSeconds,
+                uint64_t& sink) {
+    // Grow the batch until one repetition takes long enough to time reliably
+    uint64_t ops = 1;
+    while (timeBatch(bench, fixture, ops, sink) < minSeconds && ops < (uint64_t(1) << 40)) {
+        ops *= 2;
+    }
+
+    for (int i = 0; i < warmup; i++) {
+        timeBatch(bench, fixture, ops, sink);
+    }
+
+    Summary summary;
+    summary.name = bench.name;
+    summary.ops = ops;
+    for (int i = 0; i < repetitions; i++) {
+        summary.samples.push_back(timeBatch(bench, fixture, ops, sink) * 1e9 / ops);
+    }
+
+    std::vector<double> sorted = summary.samples;
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    summary.min = sorted.front();
+    summary.max = sorted.back();
+    summary.median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+    double total = 0.0, squares = 0.0;
+    for (double sample : sorted) {
+        total += sample;
+    }
+    summary.mean = total / n;
+    for (double sample : sorted) {
+        squares += (sample - summary.mean) * (sample - summary.mean);
+    }
+    summary.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+    return summary;
+}
+
+bool writeJson(const std::string& path, const std::vector<Summary>& results, int warmup, int openingMoves) {
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "Cannot write %s\n", path.c_str());
+        return false;
+    }
+
+    std::fprintf(out, "{\n  \"warmup\": %d,\n  \"opening_moves\": %d,\n  \"benchmarks\": [\n", warmup, openingMoves);
+    for (size_t i = 0; i < results.size(); i++) {
+        const Summary& s = results[i];
+        std::fprintf(out, "    {\"name\": \"%s\", \"ops\": %llu, \"ns_per_op\": {\"min\": %.3f, \"median\": %.3f, "
+                     "\"mean\": %.3f, \"stddev\": %.3f, \"max\": %.3f}, \"samples\": [",
+                     s.name.c_str(), static_cast<unsigned long long>(s.ops), s.min, s.median, s.mean, s.stddev, s.max);
+        for (size_t j = 0; j < s.samples.size(); j++) {
+            std::fprintf(out, "%s%.3f", j ? ", " : "", s.samples[j]);
+        }
+        std::fprintf(out, "]}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+    bool ok = std::ferror(out) == 0;
+    return std::fclose(out) == 0 && ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int warmup = 3, repetitions = 10, openingMoves = 8;
+    double minSeconds = 0.02;
+    std::string filter, jsonPath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--warmup" && hasValue) {
+            warmup = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--repetitions" && hasValue) {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--min-ms" && hasValue) {
+            minSeconds = std::max(1, std::atoi(argv[++i])) / 1000.0;
+        } else if (arg == "--opening" && hasValue) {
+            openingMoves = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--filter" && hasValue) {
+            filter = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = argv[++i];
+        } else if (arg == "--list") {
+            for (const Benchmark& bench : BENCHMARKS) {
+                std::printf("%-26s %s\n", bench.name, bench.help);
+            }
+            return 0;
+        } else {
+            std::fprintf(stderr, "Usage: bench [--filter text] [--warmup N] [--repetitions N] [--min-ms N]"
+                         " [--opening N] [--json path] [--list]\n");
+            return 1;
+        }
+    }
+
+    NullBuffer discard;
+    std::streambuf* previous = std::cout.rdbuf(&discard);
+    Fixture fixture(openingMoves);
+
+    std::printf("%-26s %12s %10s %10s %10s %10s %10s\n", "benchmark (ns/op)", "ops", "min", "median", "mean",
+                "stddev", "max");
+    std::vector<Summary> results;
+    uint64_t sink = 0;
+    for (const Benchmark& bench : BENCHMARKS) {
+        if (!filter.empty() && std::string(bench.name).find(filter) == std::string::npos) continue;
+
+        Summary s = measure(bench, fixture, warmup, repetitions, minSeconds, sink);
+        std::printf("%-26s %12llu %10.2f %10.2f %10.2f %10.2f %10.2f\n", s.name.c_str(),
+                    static_cast<unsigned long long>(s.ops), s.min, s.median, s.mean, s.stddev, s.max);
+        std::fflush(stdout);
+        results.push_back(s);
+    }
+    std::cout.rdbuf(previous);
+    std::printf("(checksum %llu)\n", static_cast<unsigned long long>(sink));
+
+    if (!jsonPath.empty() && !writeJson(jsonPath, results, warmup, openingMoves)) return 1;
+    return 0;
+}
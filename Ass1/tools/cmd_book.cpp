@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "commands.h"
+#include "opening_book.h"
+
+int runBookBuild(const std::vector<std::string>& args) {
+    BoardShape shape = BoardShape::english();
+    Bitboard start = shape.startPosition();
+    OpeningBookConfig config;
+    config.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string path;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        int hole;
+        if (arg == "--shape" && hasValue) {
+            if (!parseShape(args[++i], shape)) return 1;
+            start = shape.startPosition();
+        } else if (arg == "--vacancy" && hasValue) {
+            if (!parseHole(shape, args[++i], hole)) return 1;
+            start = shape.getHoles() & ~(Bitboard(1) << hole);
+        } else if (arg == "--start" && hasValue) {
+            if (!parsePattern(shape, args[++i], start)) return 1;
+        } else if (arg == "--plies" && hasValue) {
+            config.plies = std::min(std::max(0, std::atoi(args[++i].c_str())), 255);
+        } else if (arg == "--counts") {
+            config.counts = true;
+        } else if (arg == "--threads" && hasValue) {
+            config.threads = std::max(1, std::atoi(args[++i].c_str()));
+        } else if (arg == "--table-mb" && hasValue) {
+            if (!parseTableMegabytes(args[++i], config.tableMegabytes)) return 1;
+        } else if (arg == "--memo-mb" && hasValue) {
+            config.memoMegabytes = std::strtoul(args[++i].c_str(), nullptr, 10);
+        } else if (path.empty() && arg.compare(0, 2, "--") != 0) {
+            path = arg;
+        } else {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: solitaire_tool book-build <file> [--shape english|french] [--vacancy r,c | --start pattern]"
+                  << " [--plies N] [--counts] [--threads N] [--table-mb N] [--memo-mb N]" << std::endl;
+        return 1;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    if (!OpeningBook::build(shape, start, config, path)) {
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    OpeningBook book(path);
+    if (!book.isOpen()) return 1;
+    std::printf("%llu positions up to %d jumps from the start in %.1f s, written to %s\n",
+                static_cast<unsigned long long>(book.getCount()), book.getPlies(), seconds, path.c_str());
+    return 0;
+}
+
+int runBookProbe(const std::vector<std::string>& args) {
+    std::string path;
+    std::string pattern;
+    uint64_t lookups = 0;
+    uint64_t seed = 1;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        if (arg == "--start" && hasValue) {
+            pattern = args[++i];
+        } else if (arg == "--bench" && hasValue) {
+            lookups = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--seed" && hasValue) {
+            seed = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (path.empty() && arg.compare(0, 2, "--") != 0) {
+            path = arg;
+        } else {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: solitaire_tool book-probe <file> [--start pattern] [--bench N] [--seed N]" << std::endl;
+        return 1;
+    }
+
+    OpeningBook book(path);
+    if (!book.isOpen()) return 1;
+    const BoardShape& shape = book.getShape();
+    std::printf("%s board, %llu positions up to %d jumps from the start, %s\n", shape.getName().c_str(),
+                static_cast<unsigned long long>(book.getCount()), book.getPlies(),
+                book.hasCounts() ? "with solution counts" : "without counts");
+
+    if (lookups > 0) {
+        // Positions from random play inside the book's depth, looked up as played
+        std::seed_seq seeds{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+        std::mt19937_64 rng(seeds);
+        std::vector<Bitboard> positions;
+        std::vector<int> legal;
+        for (uint64_t n = 0; n < std::min<uint64_t>(lookups, 1 << 16); n++) {
+            Bitboard pegs = book.getStart();
+            int plies = std::uniform_int_distribution<int>(0, book.getPlies())(rng);
+            for (int ply = 0; ply < plies; ply++) {
+                shape.legalJumps(pegs, legal);
+                if (legal.empty()) break;
+                pegs = applyJump(pegs, shape.getJumps()[legal[rng() % legal.size()]]);
+            }
+            positions.push_back(pegs);
+        }
+
+        uint64_t hits = 0;
+        OpeningBookHit hit;
+        auto begin = std::chrono::steady_clock::now();
+        for (uint64_t n = 0; n < lookups; n++) {
+            hits += book.lookup(positions[n % positions.size()], hit);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::printf("%llu lookups, %llu hits, %.0f ns per lookup\n", static_cast<unsigned long long>(lookups),
+                    static_cast<unsigned long long>(hits), seconds * 1e9 / lookups);
+        return 0;
+    }
+
+    Bitboard pegs = book.getStart();
+    if (!pattern.empty() && !parsePattern(shape, pattern, pegs)) return 1;
+    std::cout << shape.toString(pegs) << "\n";
+
+    OpeningBookHit hit;
+    if (!book.lookup(pegs, hit)) {
+        std::printf("Not in the book\n");
+        return 1;
+    }
+    std::printf("%s", hit.solvable ? "Winnable" : "Cannot be won");
+    if (hit.counted) {
+        std::printf(", %s winning jump sequences", formatCount(hit.solutions).c_str());
+    }
+    if (hit.bestJump >= 0) {
+        const Jump& jump = shape.getJumps()[hit.bestJump];
+        std::printf(", best jump %s->%s", formatPosition(shape.position(jump.from)).c_str(),
+                    formatPosition(shape.position(jump.to)).c_str());
+    }
+    std::printf("\n");
+    return 0;
+}
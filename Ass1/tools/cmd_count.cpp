@@ -0,0 +1,102 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "commands.h"
+#include "opening_book.h"
+#include "solution_counter.h"
+
+int runCount(const std::vector<std::string>& args) {
+    BoardShape shape = BoardShape::english();
+    std::vector<Bitboard> starts;
+    bool allVacancies = false;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    int splitDepth = 4;
+    size_t memoMegabytes = 1024;
+    std::string memoFile;
+    std::string bookPath;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        int hole;
+        Bitboard pegs;
+        if (arg == "--shape" && hasValue) {
+            if (!parseShape(args[++i], shape)) return 1;
+        } else if (arg == "--vacancy" && hasValue) {
+            if (!parseHole(shape, args[++i], hole)) return 1;
+            starts.push_back(shape.getHoles() & ~(Bitboard(1) << hole));
+        } else if (arg == "--start" && hasValue) {
+            if (!parsePattern(shape, args[++i], pegs)) return 1;
+            starts.push_back(pegs);
+        } else if (arg == "--all-vacancies") {
+            allVacancies = true;
+        } else if (arg == "--threads" && hasValue) {
+            threads = std::max(1, std::atoi(args[++i].c_str()));
+        } else if (arg == "--split-depth" && hasValue) {
+            splitDepth = std::atoi(args[++i].c_str());
+        } else if (arg == "--memo-mb" && hasValue) {
+            memoMegabytes = std::strtoul(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--memo-file" && hasValue) {
+            memoFile = args[++i];
+        } else if (arg == "--book" && hasValue) {
+            bookPath = args[++i];
+        } else {
+            std::cerr << "Usage: solitaire_tool count [--shape english|french]"
+                      << " [--vacancy r,c | --start pattern | --all-vacancies] [--threads N]"
+                      << " [--split-depth N] [--memo-mb N] [--memo-file path] [--book path]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (allVacancies) {
+        for (Bitboard holes = shape.getHoles(); holes; holes &= holes - 1) {
+            starts.push_back(shape.getHoles() & ~(Bitboard(1) << lowestBit(holes)));
+        }
+    }
+    if (starts.empty()) {
+        starts.push_back(shape.startPosition());
+    }
+
+    SolutionCounter counter(shape, memoMegabytes);
+    std::unique_ptr<OpeningBook> book;
+    if (!bookPath.empty()) {
+        book.reset(new OpeningBook(bookPath));
+        if (!book->isOpen() || book->getShape().getName() != shape.getName()) {
+            std::cerr << "Not an opening book for the " << shape.getName() << " board: " << bookPath << std::endl;
+            return 1;
+        }
+        if (!book->hasCounts()) {
+            std::cerr << "Opening book " << bookPath << " has no counts (build it with --counts)" << std::endl;
+        }
+        counter.setBook(book.get());
+    }
+    if (!memoFile.empty() && counter.loadMemo(memoFile)) {
+        std::cout << "Loaded " << counter.getMemoSize() << " memo entries from " << memoFile << std::endl;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (Bitboard start : starts) {
+        SolutionCount solutions = counter.countParallel(start, threads, splitDepth);
+        if (starts.size() == 1) {
+            std::cout << shape.toString(start) << "\n";
+        } else {
+            // A single-vacancy start is named by its empty hole
+            Bitboard empty = shape.getHoles() & ~start;
+            std::cout << (popCount(empty) == 1 ? formatPosition(shape.position(lowestBit(empty))) : "start") << ": ";
+        }
+        std::cout << formatCount(solutions) << " solutions" << std::endl;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << counter.getNodes() << " positions expanded in " << seconds << " s on " << threads
+              << " thread(s), " << counter.getMemoSize() << " of " << counter.getMemoCapacity()
+              << " memo entries used" << std::endl;
+
+    if (!memoFile.empty()) {
+        if (!counter.saveMemo(memoFile)) return 1;
+        std::cout << "Memo saved to " << memoFile << std::endl;
+    }
+    return 0;
+}
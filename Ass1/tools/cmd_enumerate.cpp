@@ -0,0 +1,51 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "commands.h"
+#include "external_bfs.h"
+
+int runEnumerate(const std::vector<std::string>& args) {
+    BoardShape shape = BoardShape::english();
+    ExternalBfsConfig config;
+    int vacancy = -1;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        if (arg == "--shape" && hasValue) {
+            if (!parseShape(args[++i], shape)) return 1;
+        } else if (arg == "--vacancy" && hasValue) {
+            if (!parseHole(shape, args[++i], vacancy)) return 1;
+        } else if (arg == "--dir" && hasValue) {
+            config.directory = args[++i];
+        } else if (arg == "--memory-mb" && hasValue) {
+            config.memoryBytes = std::strtoull(args[++i].c_str(), nullptr, 10) << 20;
+        } else if (arg == "--buffer-kb" && hasValue) {
+            config.ioBufferBytes = std::strtoull(args[++i].c_str(), nullptr, 10) << 10;
+        } else if (arg == "--no-symmetry") {
+            config.useSymmetry = false;
+        } else {
+            std::cerr << "Usage: solitaire_tool enumerate [--shape english|french] [--vacancy r,c] [--dir path]"
+                      << " [--memory-mb N] [--buffer-kb N] [--no-symmetry]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (config.ioBufferBytes == 0 || config.memoryBytes < 4 * config.ioBufferBytes) {
+        std::cerr << "Memory budget must hold at least four I/O buffers" << std::endl;
+        return 1;
+    }
+
+    Bitboard start = vacancy < 0 ? shape.startPosition() : shape.getHoles() & ~(Bitboard(1) << vacancy);
+    ExternalBfs bfs(shape, config);
+    if (!bfs.run(start)) {
+        return 1;
+    }
+
+    uint64_t total = 0;
+    for (uint64_t count : bfs.getLayerCounts()) {
+        total += count;
+    }
+    std::cout << total << " positions in total, layers in " << config.directory << std::endl;
+    return 0;
+}
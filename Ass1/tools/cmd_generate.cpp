@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "commands.h"
+#include "puzzle_generator.h"
+
+int runGenerate(const std::vector<std::string>& args) {
+    BoardShape shape = BoardShape::english();
+    PuzzleGeneratorConfig config;
+    std::string outPath = "puzzles.bin";
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        if (arg == "--shape" && hasValue) {
+            if (!parseShape(args[++i], shape)) return 1;
+        } else if (arg == "--pegs" && hasValue) {
+            config.pegs = std::atoi(args[++i].c_str());
+        } else if (arg == "--count" && hasValue) {
+            config.count = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--threads" && hasValue) {
+            config.threads = std::atoi(args[++i].c_str());
+        } else if (arg == "--min-difficulty" && hasValue) {
+            config.minDifficulty = std::atoi(args[++i].c_str());
+        } else if (arg == "--max-difficulty" && hasValue) {
+            config.maxDifficulty = std::atoi(args[++i].c_str());
+        } else if (arg == "--out" && hasValue) {
+            outPath = args[++i];
+        } else {
+            std::cerr << "Usage: solitaire_tool generate [--shape english|french] [--pegs N] [--count N]"
+                      << " [--seed N] [--threads N] [--min-difficulty N] [--max-difficulty N] [--out file]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    PuzzleWriter writer(outPath, shape);
+    if (!writer.isOpen()) {
+        std::cerr << "Cannot open " << outPath << std::endl;
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    PuzzleGenerator generator(shape);
+    uint64_t written = generator.generate(config, writer);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << "Wrote " << written << " puzzles with " << config.pegs << " marbles to " << outPath
+              << " in " << seconds << " s (" << static_cast<uint64_t>(seconds > 0.0 ? written / seconds : 0.0)
+              << " puzzles/s)" << std::endl;
+    if (written < config.count) {
+        std::cerr << "Stopped short of " << config.count << ": " << PUZZLE_MAX_REJECTIONS
+                  << " candidates in a row were duplicates, failed to grow or fell outside the difficulty range"
+                  << std::endl;
+    }
+    return written == config.count ? 0 : 2;
+}
@@ -0,0 +1,60 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "bidirectional_solver.h"
+#include "commands.h"
+
+int runSolveGoal(const std::vector<std::string>& args) {
+    BoardShape shape = BoardShape::english();
+    Bitboard start = shape.startPosition();
+    Bitboard goal = Bitboard(1) << shape.getCenter();
+    int meetPegs = -1;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        int hole;
+        if (arg == "--shape" && hasValue) {
+            if (!parseShape(args[++i], shape)) return 1;
+            start = shape.startPosition();
+            goal = Bitboard(1) << shape.getCenter();
+        } else if (arg == "--vacancy" && hasValue) {
+            if (!parseHole(shape, args[++i], hole)) return 1;
+            start = shape.getHoles() & ~(Bitboard(1) << hole);
+        } else if (arg == "--start" && hasValue) {
+            if (!parsePattern(shape, args[++i], start)) return 1;
+        } else if (arg == "--finish" && hasValue) {
+            if (!parseHole(shape, args[++i], hole)) return 1;
+            goal = Bitboard(1) << hole;
+        } else if (arg == "--goal" && hasValue) {
+            if (!parsePattern(shape, args[++i], goal)) return 1;
+        } else if (arg == "--meet" && hasValue) {
+            meetPegs = std::atoi(args[++i].c_str());
+        } else {
+            std::cerr << "Usage: solitaire_tool solve-goal [--shape english|french]"
+                      << " [--vacancy r,c | --start pattern] [--finish r,c | --goal pattern] [--meet pegs]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Start:\n" << shape.toString(start) << "\nGoal:\n" << shape.toString(goal) << std::endl;
+
+    BidirectionalSolver solver(shape);
+    BidirectionalResult result = solver.solve(start, goal, meetPegs);
+
+    std::cout << result.forwardStates << " forward and " << result.backwardStates
+              << " backward positions in " << result.seconds << " s" << std::endl;
+    if (!result.solved) {
+        std::cout << "Goal cannot be reached" << std::endl;
+        return 2;
+    }
+
+    std::cout << "Met at " << result.meetPegs << " marbles, " << result.line.size() << " jumps:\n";
+    for (size_t i = 0; i < result.line.size(); i++) {
+        std::cout << "  " << (i + 1) << ": " << formatPosition(result.line[i].from)
+                  << " -> " << formatPosition(result.line[i].to) << "\n";
+    }
+    std::cout << std::flush;
+    return 0;
+}
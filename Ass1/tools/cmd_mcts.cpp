@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "commands.h"
+#include "mcts.h"
+
+static std::string formatJump(const BoardShape& shape, int id) {
+    const Jump& jump = shape.getJumps()[id];
+    return formatPosition(shape.position(jump.from)) + "->" + formatPosition(shape.position(jump.to));
+}
+
+static void printLine(const BoardShape& shape, const char* label, const std::vector<int>& line) {
+    std::printf("%s (%zu jumps):", label, line.size());
+    for (size_t i = 0; i < line.size(); i++) {
+        std::printf(" %s", formatJump(shape, line[i]).c_str());
+    }
+    std::printf("\n");
+}
+
+int runMcts(const std::vector<std::string>& args) {
+    BoardShape shape = BoardShape::english();
+    Bitboard start = shape.startPosition();
+    MctsConfig config;
+    bool play = false;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        int hole;
+        if (arg == "--shape" && hasValue) {
+            if (!parseShape(args[++i], shape)) return 1;
+            start = shape.startPosition();
+        } else if (arg == "--vacancy" && hasValue) {
+            if (!parseHole(shape, args[++i], hole)) return 1;
+            start = shape.getHoles() & ~(Bitboard(1) << hole);
+        } else if (arg == "--start" && hasValue) {
+            if (!parsePattern(shape, args[++i], start)) return 1;
+        } else if (arg == "--iterations" && hasValue) {
+            config.iterations = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--ms" && hasValue) {
+            config.milliseconds = std::atoi(args[++i].c_str());
+        } else if (arg == "--threads" && hasValue) {
+            config.threads = std::max(1, std::atoi(args[++i].c_str()));
+        } else if (arg == "--exploration" && hasValue) {
+            config.exploration = std::atof(args[++i].c_str());
+        } else if (arg == "--best-weight" && hasValue) {
+            config.bestWeight = std::atof(args[++i].c_str());
+        } else if (arg == "--pool-nodes" && hasValue) {
+            config.poolNodes = std::max(1UL, std::strtoul(args[++i].c_str(), nullptr, 10));
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--play") {
+            play = true;
+        } else {
+            std::cerr << "Usage: solitaire_tool mcts [--shape english|french] [--vacancy r,c | --start pattern]"
+                      << " [--iterations N] [--ms N] [--threads N] [--exploration C] [--best-weight W] [--pool-nodes N]"
+                      << " [--seed N] [--play]" << std::endl;
+            return 1;
+        }
+    }
+
+    MctsPlayer player(shape, config);
+    if (!play) {
+        MctsResult result = player.search(start);
+        std::printf("%llu rollouts in %.3f s (%.0f rollouts/s), %llu tree nodes\n",
+                    static_cast<unsigned long long>(result.rollouts), result.seconds, result.rolloutsPerSecond(),
+                    static_cast<unsigned long long>(result.nodes));
+        if (result.bestJump < 0) {
+            std::printf("No jumps available\n");
+            return 0;
+        }
+        std::printf("Best jump: %s, %llu visits, mean reward %.4f\n", formatJump(shape, result.bestJump).c_str(),
+                    static_cast<unsigned long long>(result.bestJumpVisits), result.bestJumpValue);
+        printLine(shape, "Principal line", result.principalLine);
+        std::printf("Best rollout left %d marble%s\n", result.bestRolloutPegs, result.bestRolloutPegs == 1 ? "" : "s");
+        printLine(shape, "Best rollout", result.bestRollout);
+        return 0;
+    }
+
+    // Play a whole game, searching afresh before every jump
+    Bitboard pegs = start;
+    std::vector<int> line;
+    uint64_t rollouts = 0;
+    double seconds = 0.0;
+    while (true) {
+        MctsResult result = player.search(pegs);
+        if (result.bestJump < 0) break;
+        rollouts += result.rollouts;
+        seconds += result.seconds;
+        line.push_back(result.bestJump);
+        pegs = applyJump(pegs, shape.getJumps()[result.bestJump]);
+        std::printf("%2zu. %-12s %8llu visits, mean %.4f\n", line.size(), formatJump(shape, result.bestJump).c_str(),
+                    static_cast<unsigned long long>(result.bestJumpVisits), result.bestJumpValue);
+        std::fflush(stdout);
+    }
+    std::printf("Finished with %d marble%s after %zu jumps; %llu rollouts in %.3f s (%.0f rollouts/s)\n",
+                popCount(pegs), popCount(pegs) == 1 ? "" : "s", line.size(), static_cast<unsigned long long>(rollouts),
+                seconds, seconds > 0.0 ? rollouts / seconds : 0.0);
+    return 0;
+}
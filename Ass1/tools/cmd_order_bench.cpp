@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include "commands.h"
+#include "dfs_solver.h"
+
+namespace {
+
+struct OrderingTotals {
+    std::string name;
+    int solved = 0;
+    int aborted = 0;
+    uint64_t nodes = 0;
+    double seconds = 0.0;
+};
+
+} // namespace
+
+int runOrderBench(const std::vector<std::string>& args) {
+    BoardShape shape = BoardShape::english();
+    std::vector<std::string> orderings = MoveOrderer::names();
+    uint64_t maxNodes = 20000000;
+    size_t tableMegabytes = 64;
+    bool verbose = false;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        if (arg == "--shape" && hasValue) {
+            if (!parseShape(args[++i], shape)) return 1;
+        } else if (arg == "--orderings" && hasValue) {
+            // Comma-separated list of orderer names
+            orderings.clear();
+            std::istringstream in(args[++i]);
+            std::string name;
+            while (std::getline(in, name, ',')) {
+                orderings.push_back(name);
+            }
+        } else if (arg == "--max-nodes" && hasValue) {
+            maxNodes = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--table-mb" && hasValue) {
+            if (!parseTableMegabytes(args[++i], tableMegabytes)) return 1;
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else {
+            std::cerr << "Usage: solitaire_tool order-bench [--shape english|french]"
+                      << " [--orderings fixed,history,killer,mobility,combined] [--max-nodes N]"
+                      << " [--table-mb N] [--verbose]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<OrderingTotals> totals;
+    for (const std::string& name : orderings) {
+        std::unique_ptr<MoveOrderer> orderer = MoveOrderer::create(shape, name);
+        if (!orderer) {
+            std::cerr << "Unknown move ordering: " << name << std::endl;
+            return 1;
+        }
+
+        OrderingTotals total;
+        total.name = name;
+        DfsSolver solver(shape, *orderer, tableMegabytes);
+
+        // Every single-vacancy start, finishing anywhere
+        Bitboard holes = shape.getHoles();
+        while (holes) {
+            int vacancy = lowestBit(holes);
+            holes &= holes - 1;
+
+            DfsResult result = solver.solve(shape.getHoles() & ~(Bitboard(1) << vacancy), -1, maxNodes);
+            total.solved += result.solved;
+            total.aborted += result.aborted;
+            total.nodes += result.nodes;
+            total.seconds += result.seconds;
+
+            if (verbose) {
+                std::cout << name << " " << formatPosition(shape.position(vacancy)) << ": "
+                          << (result.solved ? "solved" : result.aborted ? "node limit" : "no solution")
+                          << ", " << result.nodes << " nodes, " << result.seconds * 1000.0 << " ms" << std::endl;
+            }
+        }
+        totals.push_back(total);
+    }
+
+    std::cout << "\n" << shape.getHoleCount() << " single-vacancy starts on the " << shape.getName()
+              << " board, node limit " << maxNodes << "\n\n";
+    std::printf("%-10s %7s %7s %14s %10s %9s\n", "ordering", "solved", "limit", "nodes", "seconds", "vs first");
+    for (const OrderingTotals& total : totals) {
+        double ratio = totals[0].nodes ? double(total.nodes) / totals[0].nodes : 0.0;
+        std::printf("%-10s %7d %7d %14llu %10.3f %8.2fx\n", total.name.c_str(), total.solved, total.aborted,
+                    static_cast<unsigned long long>(total.nodes), total.seconds, ratio);
+    }
+    std::fflush(stdout);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+
+#include "commands.h"
+#include "game_record.h"
+
+static void showRecord(const GameRecordReader& reader, uint64_t n) {
+    GameRecordView view;
+    if (!reader.get(n, view)) {
+        std::printf("No record %llu (%llu in the file)\n", static_cast<unsigned long long>(n),
+                    static_cast<unsigned long long>(reader.getCount()));
+        return;
+    }
+
+    const GameRecordHeader& header = view.header;
+    BoardShape shape = shapeForRecord(header.shape);
+    Bitboard pegs;
+    bool valid = reader.validate(view, pegs);
+    std::time_t started = static_cast<std::time_t>(header.startMillis / 1000);
+    char when[32];
+    std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", std::gmtime(&started));
+
+    std::printf("Record %llu: %s board, seed %llu, started %s UTC, %u ms\n", static_cast<unsigned long long>(n),
+                shape.getName().c_str(), static_cast<unsigned long long>(header.seed), when, header.durationMillis);
+    std::printf("%d jumps:", header.jumps);
+    for (int i = 0; i < header.jumps; i++) {
+        if (view.jumps[i] >= shape.getJumps().size()) {
+            std::printf(" ?");
+            continue;
+        }
+        const Jump& jump = shape.getJumps()[view.jumps[i]];
+        std::printf(" %s->%s", formatPosition(shape.position(jump.from)).c_str(),
+                    formatPosition(shape.position(jump.to)).c_str());
+    }
+    if (valid) {
+        std::printf("\nValid, %d marble%s left\n", popCount(pegs), popCount(pegs) == 1 ? "" : "s");
+    } else {
+        std::printf("\nINVALID: a jump is illegal or unknown\n");
+    }
+}
+
+int runRecords(const std::vector<std::string>& args) {
+    std::string path;
+    bool show = false;
+    uint64_t showIndex = 0;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        if (arg == "--show" && hasValue) {
+            show = true;
+            showIndex = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (path.empty() && arg.compare(0, 2, "--") != 0) {
+            path = arg;
+        } else {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty()) {
+        std::cerr << "Usage: solitaire_tool records <file> [--show N]" << std::endl;
+        return 1;
+    }
+
+    GameRecordReader reader(path);
+    if (!reader.isOpen()) return 1;
+    if (show) {
+        showRecord(reader, showIndex);
+        return 0;
+    }
+
+    // Stream every record through the engine
+    auto start = std::chrono::steady_clock::now();
+    uint64_t records = 0, invalid = 0, wins = 0, jumps = 0;
+    GameRecordView view;
+    Bitboard pegs;
+    while (reader.next(view)) {
+        records++;
+        jumps += view.header.jumps;
+        if (!reader.validate(view, pegs)) {
+            invalid++;
+        } else {
+            wins += popCount(pegs) == 1;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%llu records (%llu indexed%s), %llu invalid, %llu won, %.2f jumps on average\n",
+                static_cast<unsigned long long>(records), static_cast<unsigned long long>(reader.getCount()),
+                reader.hasIndex() ? "" : ", index rebuilt by scanning", static_cast<unsigned long long>(invalid),
+                static_cast<unsigned long long>(wins), records ? double(jumps) / records : 0.0);
+    std::printf("Replayed in %.3f s (%.0f records/s)\n", seconds, seconds > 0.0 ? records / seconds : 0.0);
+    return invalid ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include "commands.h"
+#include "game_record.h"
+#include "hint_client.h"
+#include "hint_service.h"
+
+int runServe(const std::vector<std::string>& args) {
+    std::string socketPath = HINT_DEFAULT_SOCKET;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t tableMegabytes = 256;
+    size_t memoMegabytes = 256;
+    size_t batchSize = 64;
+    std::vector<std::string> bookPaths;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        if (arg == "--socket" && hasValue) {
+            socketPath = args[++i];
+        } else if (arg == "--threads" && hasValue) {
+            threads = std::max(1, std::atoi(args[++i].c_str()));
+        } else if (arg == "--table-mb" && hasValue) {
+            if (!parseTableMegabytes(args[++i], tableMegabytes)) return 1;
+        } else if (arg == "--memo-mb" && hasValue) {
+            memoMegabytes = std::strtoul(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--batch" && hasValue) {
+            batchSize = std::max(1UL, std::strtoul(args[++i].c_str(), nullptr, 10));
+        } else if (arg == "--book" && hasValue) {
+            bookPaths.push_back(args[++i]);
+        } else {
+            std::cerr << "Usage: solitaire_tool serve [--socket path] [--threads N] [--table-mb N] [--memo-mb N]"
+                      << " [--batch N] [--book path]..." << std::endl;
+            return 1;
+        }
+    }
+
+    HintService service(tableMegabytes, memoMegabytes);
+    std::vector<std::unique_ptr<OpeningBook> > books;
+    for (const std::string& path : bookPaths) {
+        books.emplace_back(new OpeningBook(path));
+        if (!books.back()->isOpen() || !service.setBook(books.back().get())) return 1;
+        std::printf("Opening book %s: %llu %s positions\n", path.c_str(),
+                    static_cast<unsigned long long>(books.back()->getCount()), books.back()->getShape().getName().c_str());
+    }
+    HintServer server(service, socketPath, threads, batchSize);
+    std::printf("Serving hints on %s with %d workers, batches of up to %zu\n", socketPath.c_str(), threads, batchSize);
+    std::fflush(stdout);
+    if (!server.run()) {
+        return 1;
+    }
+
+    HintServerStats stats = server.getStats();
+    std::printf("%llu requests from %llu connections in %llu batches (%.1f per batch), %llu deduplicated\n",
+                static_cast<unsigned long long>(stats.requests), static_cast<unsigned long long>(stats.connections),
+                static_cast<unsigned long long>(stats.batches),
+                stats.batches ? double(stats.requests) / stats.batches : 0.0,
+                static_cast<unsigned long long>(stats.deduplicated));
+    return 0;
+}
+
+// Positions a few random jumps into the game: what players actually ask about
+static std::vector<Bitboard> samplePositions(const BoardShape& shape, int depth, size_t count, uint64_t seed) {
+    std::seed_seq seeds{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    std::mt19937_64 rng(seeds);
+    const std::vector<Jump>& jumps = shape.getJumps();
+    std::vector<int> legal;
+
+    std::vector<Bitboard> positions;
+    for (size_t n = 0; n < count; n++) {
+        Bitboard pegs = shape.startPosition();
+        for (int ply = 0; ply < depth; ply++) {
+            legal.clear();
+            for (size_t id = 0; id < jumps.size(); id++) {
+                if (canJump(pegs, jumps[id])) legal.push_back(static_cast<int>(id));
+            }
+            if (legal.empty()) break;
+            pegs = applyJump(pegs, jumps[legal[std::uniform_int_distribution<size_t>(0, legal.size() - 1)(rng)]]);
+        }
+        positions.push_back(pegs);
+    }
+    return positions;
+}
+
+int runHintLoad(const std::vector<std::string>& args) {
+    std::string socketPath = HINT_DEFAULT_SOCKET;
+    BoardShape shape = BoardShape::english();
+    int connections = 4;
+    uint64_t total = 100000;
+    int op = HINT_OP_HINT;
+    int depth = 12;
+    size_t pipeline = 16;
+    size_t distinct = 4096;
+    uint64_t seed = 1;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        if (arg == "--socket" && hasValue) {
+            socketPath = args[++i];
+        } else if (arg == "--shape" && hasValue) {
+            if (!parseShape(args[++i], shape)) return 1;
+        } else if (arg == "--connections" && hasValue) {
+            connections = std::max(1, std::atoi(args[++i].c_str()));
+        } else if (arg == "--requests" && hasValue) {
+            total = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--op" && hasValue) {
+            std::string name = args[++i];
+            op = name == "solve" ? HINT_OP_SOLVE : name == "hint" ? HINT_OP_HINT
+               : name == "solvable" ? HINT_OP_IS_SOLVABLE : name == "count" ? HINT_OP_COUNT : 0;
+            if (!op) {
+                std::cerr << "Unknown op: " << name << std::endl;
+                return 1;
+            }
+        } else if (arg == "--depth" && hasValue) {
+            depth = std::max(0, std::atoi(args[++i].c_str()));
+        } else if (arg == "--pipeline" && hasValue) {
+            pipeline = std::max(1UL, std::strtoul(args[++i].c_str(), nullptr, 10));
+        } else if (arg == "--positions" && hasValue) {
+            distinct = std::max(1UL, std::strtoul(args[++i].c_str(), nullptr, 10));
+        } else if (arg == "--seed" && hasValue) {
+            seed = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else {
+            std::cerr << "Usage: solitaire_tool hint-load [--socket path] [--shape english|french] [--connections N]"
+                      << " [--requests N] [--op solve|hint|solvable|count] [--depth N] [--pipeline N]"
+                      << " [--positions N] [--seed N]" << std::endl;
+            return 1;
+        }
+    }
+
+    uint8_t shapeId;
+    if (!recordShapeFor(shape, shapeId)) {
+        std::cerr << "The hint service only knows the English and French boards" << std::endl;
+        return 1;
+    }
+    std::vector<Bitboard> positions = samplePositions(shape, depth, distinct, seed);
+
+    typedef std::chrono::steady_clock Clock;
+    std::vector<std::vector<double> > latencies(connections);
+    std::vector<uint64_t> failures(connections, 0);
+    std::vector<std::thread> clients;
+    Clock::time_point begin = Clock::now();
+
+    for (int c = 0; c < connections; c++) {
+        clients.push_back(std::thread([&, c]() {
+            HintClient client;
+            uint64_t share = total / connections + (uint64_t(c) < total % connections);
+            if (!client.connect(socketPath)) {
+                failures[c] = share;
+                return;
+            }
+
+            // Keep up to `pipeline` requests in flight; ids index the send times
+            std::vector<Clock::time_point> sentAt(share);
+            std::vector<double>& measured = latencies[c];
+            measured.reserve(share);
+            std::vector<HintRequest> burst;
+            uint64_t sent = 0, received = 0;
+            while (received < share) {
+                burst.clear();
+                while (sent < share && sent - received + burst.size() < pipeline) {
+                    HintRequest request;
+                    request.id = static_cast<uint32_t>(sent + burst.size());
+                    request.op = static_cast<uint8_t>(op);
+                    request.shape = shapeId;
+                    request.reserved = 0;
+                    request.pegs = positions[(request.id * uint64_t(connections) + c) % positions.size()];
+                    burst.push_back(request);
+                }
+                Clock::time_point now = Clock::now();
+                for (const HintRequest& request : burst) {
+                    sentAt[request.id] = now;
+                }
+                if (!burst.empty() && !client.send(burst)) break;
+                sent += burst.size();
+
+                HintResponse response;
+                if (!client.receive(response)) break;
+                received++;
+                if (response.status == HINT_BAD_REQUEST || response.id >= share) {
+                    failures[c]++;
+                    continue;
+                }
+                measured.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sentAt[response.id]).count());
+            }
+            failures[c] += share - received;
+        }));
+    }
+    for (size_t i = 0; i < clients.size(); i++) {
+        clients[i].join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    std::vector<double> all;
+    uint64_t failed = 0;
+    for (int c = 0; c < connections; c++) {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        failed += failures[c];
+    }
+    if (all.empty()) {
+        std::cerr << "No responses from " << socketPath << " (is solitaire_tool serve running?)" << std::endl;
+        return 1;
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&](double p) { return all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))]; };
+
+    std::printf("%zu responses over %d connections in %.3f s: %.0f queries/s, %llu failed\n", all.size(), connections,
+                seconds, all.size() / seconds, static_cast<unsigned long long>(failed));
+    std::printf("Latency (us): p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n", percentile(0.50),
+                percentile(0.90), percentile(0.99), percentile(0.999), all.back());
+    return failed ? 1 : 0;
+}
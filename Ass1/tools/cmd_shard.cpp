@@ -0,0 +1,184 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "commands.h"
+#include "shard.h"
+
+extern char** environ;
+
+namespace {
+
+struct ShardOptions {
+    BoardShape shape = BoardShape::english();
+    Bitboard start = 0;
+    int depth = 4;
+    int index = 0;
+    int count = 1;
+    std::string directory = "shards";
+    std::string shapeName = "english";
+    std::string vacancyText;
+    std::string patternText;
+};
+
+bool parseShardOptions(const std::vector<std::string>& args, ShardOptions& options) {
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        if (arg == "--shape" && hasValue) {
+            options.shapeName = args[++i];
+            if (!parseShape(options.shapeName, options.shape)) return false;
+        } else if (arg == "--vacancy" && hasValue) {
+            options.vacancyText = args[++i];
+        } else if (arg == "--start" && hasValue) {
+            options.patternText = args[++i];
+        } else if (arg == "--depth" && hasValue) {
+            options.depth = std::atoi(args[++i].c_str());
+        } else if ((arg == "--index") && hasValue) {
+            options.index = std::atoi(args[++i].c_str());
+        } else if ((arg == "--count" || arg == "--workers") && hasValue) {
+            options.count = std::atoi(args[++i].c_str());
+        } else if (arg == "--dir" && hasValue) {
+            options.directory = args[++i];
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+    if (options.count < 1 || options.index < 0 || options.index >= options.count || options.depth < 0) {
+        std::cerr << "Need 0 <= index < count and depth >= 0" << std::endl;
+        return false;
+    }
+
+    // The start is read only once the board is known, whatever the option order
+    int hole;
+    options.start = options.shape.startPosition();
+    if (!options.vacancyText.empty() && !options.patternText.empty()) {
+        std::cerr << "Give either --vacancy or --start, not both" << std::endl;
+        return false;
+    } else if (!options.vacancyText.empty()) {
+        if (!parseHole(options.shape, options.vacancyText, hole)) return false;
+        options.start = options.shape.getHoles() & ~(Bitboard(1) << hole);
+    } else if (!options.patternText.empty()) {
+        if (!parsePattern(options.shape, options.patternText, options.start)) return false;
+    }
+    return true;
+}
+
+std::string shardPath(const ShardOptions& options, int index) {
+    return options.directory + "/shard_" + std::to_string(index) + "_of_" + std::to_string(options.count) + ".txt";
+}
+
+int mergeAndReport(const ShardOptions& options) {
+    std::vector<ShardResult> shards(options.count);
+    for (int i = 0; i < options.count; i++) {
+        if (!readShardResult(shardPath(options, i), shards[i])) {
+            std::cerr << "Missing or incomplete " << shardPath(options, i) << std::endl;
+            return 1;
+        }
+    }
+
+    if (shards[0].start != options.start) {
+        std::cerr << "The shards in " << options.directory << " analysed a different start" << std::endl;
+        return 1;
+    }
+
+    MergedResult merged;
+    std::string error;
+    if (!mergeShardResults(shards, merged, error)) {
+        std::cerr << "Merge failed: " << error << std::endl;
+        return 1;
+    }
+
+    // Solvability bits as hex, four prefixes per digit, lowest index first
+    std::string bits;
+    for (size_t i = 0; i < merged.solvable.size(); i += 4) {
+        int digit = 0;
+        for (size_t j = 0; j < 4 && i + j < merged.solvable.size(); j++) {
+            digit |= merged.solvable[i + j] ? (1 << j) : 0;
+        }
+        bits += "0123456789abcdef"[digit];
+    }
+
+    std::string summaryPath = options.directory + "/merged.txt";
+    std::ofstream summary(summaryPath.c_str());
+    summary << "shards " << options.count << "\n"
+            << "prefixes " << merged.solvable.size() << "\n"
+            << "solvable_prefixes " << merged.solvablePrefixes << "\n"
+            << "solutions " << formatCount(merged.solutions) << "\n"
+            << "solvable_bits " << bits << "\n"
+            << "nodes " << merged.nodes << "\n";
+
+    std::cout << merged.solvable.size() << " opening prefixes, " << merged.solvablePrefixes << " solvable\n"
+              << formatCount(merged.solutions) << " solutions in total\n"
+              << merged.nodes << " nodes, " << merged.cpuSeconds << " s CPU, slowest shard "
+              << merged.wallSeconds << " s\nSummary written to " << summaryPath << std::endl;
+    return 0;
+}
+
+} // namespace
+
+int runShardWorker(const std::vector<std::string>& args) {
+    ShardOptions options;
+    if (!parseShardOptions(args, options)) return 1;
+    mkdir(options.directory.c_str(), 0755);
+
+    ShardResult result = runShard(options.shape, options.start, options.depth, options.index, options.count);
+    if (!writeShardResult(shardPath(options, options.index), result)) {
+        std::cerr << "Cannot write " << shardPath(options, options.index) << std::endl;
+        return 1;
+    }
+    std::cout << "Shard " << options.index << "/" << options.count << ": " << result.prefixes.size()
+              << " prefixes, " << result.nodes << " nodes in " << result.seconds << " s" << std::endl;
+    return 0;
+}
+
+int runShardMerge(const std::vector<std::string>& args) {
+    ShardOptions options;
+    if (!parseShardOptions(args, options)) return 1;
+    return mergeAndReport(options);
+}
+
+int runShardLocal(const std::vector<std::string>& args) {
+    ShardOptions options;
+    if (!parseShardOptions(args, options)) return 1;
+    mkdir(options.directory.c_str(), 0755);
+
+    // Each worker is this executable again, run as a separate process. They
+    // get the start this process resolved, so all of them analyse the same one.
+    std::vector<pid_t> workers;
+    for (int i = 0; i < options.count; i++) {
+        std::vector<std::string> workerArgs = {
+            "solitaire_tool", "shard", "--shape", options.shapeName,
+            "--start", formatPattern(options.shape, options.start), "--depth", std::to_string(options.depth),
+            "--index", std::to_string(i), "--count", std::to_string(options.count), "--dir", options.directory};
+
+        std::vector<char*> argv;
+        for (std::string& arg : workerArgs) {
+            argv.push_back(&arg[0]);
+        }
+        argv.push_back(nullptr);
+
+        pid_t pid;
+        if (posix_spawn(&pid, "/proc/self/exe", nullptr, nullptr, argv.data(), environ) != 0) {
+            std::cerr << "Failed to launch worker " << i << std::endl;
+            return 1;
+        }
+        workers.push_back(pid);
+    }
+
+    bool failed = false;
+    for (pid_t pid : workers) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        failed = failed || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }
+    if (failed) {
+        std::cerr << "A worker failed" << std::endl;
+        return 1;
+    }
+    return mergeAndReport(options);
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+#include "commands.h"
+#include "simulator.h"
+
+int runSimulate(const std::vector<std::string>& args) {
+    BoardShape shape = BoardShape::english();
+    Bitboard start = shape.startPosition();
+    SimulationConfig config;
+    std::string csvPath, jsonPath, recordPath;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        int hole;
+        if (arg == "--shape" && hasValue) {
+            if (!parseShape(args[++i], shape)) return 1;
+            start = shape.startPosition();
+        } else if (arg == "--vacancy" && hasValue) {
+            if (!parseHole(shape, args[++i], hole)) return 1;
+            start = shape.getHoles() & ~(Bitboard(1) << hole);
+        } else if (arg == "--start" && hasValue) {
+            if (!parsePattern(shape, args[++i], start)) return 1;
+        } else if (arg == "--policy" && hasValue) {
+            if (!parsePolicy(args[++i], config.policy)) {
+                std::cerr << "Unknown policy: " << args[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--games" && hasValue) {
+            config.games = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = std::strtoull(args[++i].c_str(), nullptr, 10);
+        } else if (arg == "--threads" && hasValue) {
+            config.threads = std::atoi(args[++i].c_str());
+        } else if (arg == "--epsilon" && hasValue) {
+            config.epsilon = std::atof(args[++i].c_str());
+        } else if (arg == "--oracle-mb" && hasValue) {
+            if (!parseTableMegabytes(args[++i], config.oracleMegabytes)) return 1;
+        } else if (arg == "--oracle-nodes" && hasValue) {
+            config.oracleNodes = std::max(1ULL, std::strtoull(args[++i].c_str(), nullptr, 10));
+        } else if (arg == "--mcts-iterations" && hasValue) {
+            config.mctsIterations = std::max(1ULL, std::strtoull(args[++i].c_str(), nullptr, 10));
+        } else if (arg == "--csv" && hasValue) {
+            csvPath = args[++i];
+        } else if (arg == "--json" && hasValue) {
+            jsonPath = args[++i];
+        } else if (arg == "--record" && hasValue) {
+            recordPath = args[++i];
+        } else {
+            std::cerr << "Usage: solitaire_tool simulate [--shape english|french] [--vacancy r,c | --start pattern]"
+                      << " [--policy random|greedy|epsilon|mcts] [--games N] [--seed N] [--threads N]"
+                      << " [--epsilon P] [--oracle-mb N] [--oracle-nodes N] [--mcts-iterations N] [--csv path] [--json path]"
+                      << " [--record path]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::unique_ptr<GameRecordWriter> recorder;
+    if (!recordPath.empty()) {
+        recorder.reset(new GameRecordWriter(recordPath));
+        if (!recorder->isOpen()) return 1;
+    }
+
+    Simulator simulator(shape);
+    SimulationStats stats = simulator.run(start, config, recorder.get());
+    if (recorder && !recorder->close()) {
+        std::cerr << "Failed to write " << recordPath << std::endl;
+        return 1;
+    }
+
+    double totalPegs = 0.0;
+    for (size_t i = 0; i < stats.finalPegs.size(); i++) {
+        totalPegs += double(i) * stats.finalPegs[i];
+    }
+    std::printf("%llu %s games in %.3f s (%.0f games/min)\n", static_cast<unsigned long long>(stats.games),
+                policyName(config.policy), stats.seconds, stats.seconds > 0.0 ? stats.games * 60.0 / stats.seconds : 0.0);
+    std::printf("Won %llu (%.4f%%), %.3f marbles left on average\n\nMarbles left:\n",
+                static_cast<unsigned long long>(stats.wins), stats.games ? 100.0 * stats.wins / stats.games : 0.0,
+                stats.games ? totalPegs / stats.games : 0.0);
+    for (size_t i = 0; i < stats.finalPegs.size(); i++) {
+        if (stats.finalPegs[i]) {
+            std::printf("  %2zu: %llu\n", i, static_cast<unsigned long long>(stats.finalPegs[i]));
+        }
+    }
+    std::fflush(stdout);
+
+    if (!csvPath.empty() && !Simulator::writeCsv(csvPath, shape, stats)) return 1;
+    if (!jsonPath.empty() && !Simulator::writeJson(jsonPath, shape, config, stats)) return 1;
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "commands.h"
+#include "min_move_solver.h"
+
+int runSolveMinMoves(const std::vector<std::string>& args) {
+    BoardShape shape = BoardShape::english();
+    int vacancy = shape.getCenter();
+    int goal = shape.getCenter();
+    size_t tableMegabytes = 256;
+    int maxMoves = 40;
+    ReplacementPolicy policy = REPLACE_DEPTH_PREFERRED;
+    bool hugePages = false;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        const std::string& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+        if (arg == "--shape" && hasValue) {
+            if (!parseShape(args[++i], shape)) return 1;
+            vacancy = goal = shape.getCenter();
+        } else if (arg == "--vacancy" && hasValue) {
+            if (!parseHole(shape, args[++i], vacancy)) return 1;
+        } else if (arg == "--goal" && hasValue) {
+            if (args[i + 1] == "any") {
+                goal = -1;
+                i++;
+            } else if (!parseHole(shape, args[++i], goal)) {
+                return 1;
+            }
+        } else if (arg == "--table-mb" && hasValue) {
+            if (!parseTableMegabytes(args[++i], tableMegabytes)) return 1;
+        } else if (arg == "--replace" && hasValue) {
+            policy = args[++i] == "always" ? REPLACE_ALWAYS : REPLACE_DEPTH_PREFERRED;
+        } else if (arg == "--huge-pages") {
+            hugePages = true;
+        } else if (arg == "--max-moves" && hasValue) {
+            maxMoves = std::atoi(args[++i].c_str());
+        } else {
+            std::cerr << "Usage: solitaire_tool solve-min [--shape english|french] [--vacancy r,c]"
+                      << " [--goal r,c|any] [--table-mb N] [--replace always|depth] [--huge-pages]"
+                      << " [--max-moves N]" << std::endl;
+            return 1;
+        }
+    }
+
+    Bitboard start = shape.getHoles() & ~(Bitboard(1) << vacancy);
+    std::cout << "Solving " << shape.getName() << " board, " << popCount(start) << " marbles:\n"
+              << shape.toString(start) << std::endl;
+
+    MinMoveSolver solver(shape, tableMegabytes, policy, hugePages);
+    solver.setVerbose(true);
+    MinMoveResult result = solver.solve(start, goal, maxMoves);
+
+    TranspositionStats stats = solver.getTable().getStats();
+    std::cout << "Table: " << (solver.getTable().getBytes() >> 20) << " MB"
+              << (solver.getTable().usesHugePages() ? " (huge pages)" : "") << ", hit rate "
+              << 100.0 * stats.hitRate() << "%, " << stats.collisions << " collisions, occupancy "
+              << 100.0 * stats.occupancy() << "%" << std::endl;
+    std::cout << "Heap allocations during search: " << result.searchAllocations << std::endl;
+
+    if (!result.solved) {
+        std::cout << "No solution within " << maxMoves << " moves" << std::endl;
+        return 2;
+    }
+
+    std::cout << "\nOptimal solution: " << result.moves << " moves\n";
+    for (size_t i = 0; i < result.line.size(); i++) {
+        std::cout << "  " << (i + 1) << ": ";
+        for (size_t j = 0; j < result.line[i].size(); j++) {
+            std::cout << (j ? " -> " : "") << formatPosition(result.line[i][j]);
+        }
+        std::cout << "\n";
+    }
+    std::cout << result.nodes << " nodes in " << result.seconds << " s ("
+              << static_cast<uint64_t>(result.nodesPerSecond()) << " nodes/s)" << std::endl;
+    return 0;
+}
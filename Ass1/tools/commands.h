@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+
+// Headless subcommands of solitaire_tool. Each takes the arguments that
+// follow its name and returns the process exit code.
+int runSolveMinMoves(const std::vector<std::string>& args);
+int runSolveGoal(const std::vector<std::string>& args);
+int runGenerate(const std::vector<std::string>& args);
+int runEnumerate(const std::vector<std::string>& args);
+int runShardWorker(const std::vector<std::string>& args);
+int runShardMerge(const std::vector<std::string>& args);
+int runShardLocal(const std::vector<std::string>& args);
+int runOrderBench(const std::vector<std::string>& args);
+int runCount(const std::vector<std::string>& args);
+int runSimulate(const std::vector<std::string>& args);
+int runMcts(const std::vector<std::string>& args);
+int runRecords(const std::vector<std::string>& args);
+int runServe(const std::vector<std::string>& args);
+int runHintLoad(const std::vector<std::string>& args);
+int runBookBuild(const std::vector<std::string>& args);
+int runBookProbe(const std::vector<std::string>& args);
+
+// Shared argument helpers
+bool parseShape(const std::string& name, BoardShape& shape);
+bool parseHole(const BoardShape& shape, const std::string& text, int& hole);
+bool parsePattern(const BoardShape& shape, const std::string& text, Bitboard& pegs);
+std::string formatPattern(const BoardShape& shape, Bitboard pegs);
+bool parseTableMegabytes(const std::string& text, size_t& megabytes);
+std::string formatPosition(const Position& pos);
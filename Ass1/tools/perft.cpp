@@ -0,0 +1,203 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "bitboard.h"
+#include "game.h"
+
+// Move-path counter for the bitboard engine: the number of jump sequences
+// of a given length from a named position. The counts are fixed by the
+// rules, so any engine change that alters them is a bug, and the time they
+// take is the engine's speed.
+
+namespace {
+
+struct NamedPosition {
+    const char* name;
+    const char* shape;      // "game" is the board of MarbleSolitaire::initializeBoard()
+    int row, col;           // Single vacancy; -1 for the shape's usual start
+};
+
+const NamedPosition POSITIONS[] = {
+    {"start", "game", -1, -1},
+    {"english-corner", "english", 0, 2},
+    {"english-edge", "english", 0, 3},
+    {"english-inner", "english", 2, 3},
+    {"french", "french", -1, -1},
+};
+
+struct KnownAnswer {
+    const char* position;
+    int depth;
+    uint64_t leaves;
+};
+
+// Counted with both bulk and full expansion, and cross-checked against
+// MarbleSolitaire::makeMove() for the English start
+const KnownAnswer KNOWN_ANSWERS[] = {
+    {"start", 1, 4},
+    {"start", 2, 12},
+    {"start", 3, 60},
+    {"start", 4, 400},
+    {"start", 5, 2960},
+    {"start", 6, 24600},
+    {"start", 7, 221072},
+    {"start", 8, 2076744},
+    {"start", 9, 20123080},
+    {"english-corner", 8, 1831918},
+    {"english-edge", 8, 519186},
+    {"english-inner", 8, 4587400},
+    {"french", 7, 1028872},
+};
+
+struct PerftCounter {
+    const std::vector<Jump>& jumps;
+    bool bulk;
+    uint64_t nodes;     // Positions made, excluding bulk-counted leaves
+
+    uint64_t count(Bitboard pegs, int depth) {
+        nodes++;
+        if (depth == 0) {
+            return 1;
+        }
+
+        uint64_t leaves = 0;
+        if (bulk && depth == 1) {
+            // The last ply only needs the number of legal jumps
+            for (const Jump& jump : jumps) {
+                leaves += canJump(pegs, jump);
+            }
+            return leaves;
+        }
+        for (const Jump& jump : jumps) {
+            if (canJump(pegs, jump)) {
+                leaves += count(applyJump(pegs, jump), depth - 1);
+            }
+        }
+        return leaves;
+    }
+};
+
+bool findPosition(const std::string& name, BoardShape& shape, Bitboard& pegs) {
+    for (const NamedPosition& named : POSITIONS) {
+        if (name != named.name) continue;
+
+        shape = std::strcmp(named.shape, "french") == 0 ? BoardShape::french() : BoardShape::english();
+        if (std::strcmp(named.shape, "game") == 0) {
+            // The game prints its board when created; keep that out of the report
+            std::ostringstream discard;
+            std::streambuf* previous = std::cout.rdbuf(discard.rdbuf());
+            MarbleSolitaire game(shape.getSize());
+            std::cout.rdbuf(previous);
+            pegs = shape.fromGame(game);
+        } else if (named.row < 0) {
+            pegs = shape.startPosition();
+        } else {
+            pegs = shape.getHoles() & ~(Bitboard(1) << shape.index(named.row, named.col));
+        }
+        return true;
+    }
+    std::cerr << "Unknown position: " << name << std::endl;
+    return false;
+}
+
+std::string formatJump(const BoardShape& shape, const Jump& jump) {
+    Position from = shape.position(jump.from), to = shape.position(jump.to);
+    return "(" + std::to_string(from.row) + "," + std::to_string(from.col) + ")->(" + std::to_string(to.row) + "," +
+           std::to_string(to.col) + ")";
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int verify(bool bulk) {
+    int failures = 0;
+    for (const KnownAnswer& known : KNOWN_ANSWERS) {
+        BoardShape shape = BoardShape::english();
+        Bitboard pegs;
+        if (!findPosition(known.position, shape, pegs)) return 1;
+
+        PerftCounter counter = {shape.getJumps(), bulk, 0};
+        auto start = std::chrono::steady_clock::now();
+        uint64_t leaves = counter.count(pegs, known.depth);
+        double seconds = secondsSince(start);
+        bool ok = leaves == known.leaves;
+        failures += !ok;
+        std::printf("%-4s %-15s depth %2d: %14llu", ok ? "ok" : "FAIL", known.position, known.depth,
+                    static_cast<unsigned long long>(leaves));
+        if (!ok) {
+            std::printf(" (expected %llu)", static_cast<unsigned long long>(known.leaves));
+        }
+        std::printf("  %.3f s\n", seconds);
+    }
+    std::printf("%s\n", failures ? "Known-answer check FAILED" : "All known answers match");
+    return failures ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string name = "start";
+    int depth = 8;
+    bool bulk = true, divide = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--position" && hasValue) {
+            name = argv[++i];
+        } else if (arg == "--depth" && hasValue) {
+            depth = std::atoi(argv[++i]);
+        } else if (arg == "--divide") {
+            divide = true;
+        } else if (arg == "--no-bulk") {
+            bulk = false;
+        } else if (arg == "--verify") {
+            return verify(bulk);
+        } else if (arg == "--list") {
+            for (const NamedPosition& named : POSITIONS) {
+                std::cout << named.name << "\n";
+            }
+            return 0;
+        } else {
+            std::cerr << "Usage: perft [--position name] [--depth N] [--divide] [--no-bulk] [--verify] [--list]"
+                      << std::endl;
+            return 1;
+        }
+    }
+    if (depth < 0) {
+        std::cerr << "Depth must not be negative" << std::endl;
+        return 1;
+    }
+
+    BoardShape shape = BoardShape::english();
+    Bitboard pegs;
+    if (!findPosition(name, shape, pegs)) return 1;
+
+    PerftCounter counter = {shape.getJumps(), bulk, 0};
+    auto start = std::chrono::steady_clock::now();
+    uint64_t leaves = 0;
+    if (divide && depth > 0) {
+        // One subtotal per first jump, to narrow a mismatch down to a move
+        for (const Jump& jump : shape.getJumps()) {
+            if (!canJump(pegs, jump)) continue;
+            uint64_t subtotal = counter.count(applyJump(pegs, jump), depth - 1);
+            std::printf("%-14s %llu\n", formatJump(shape, jump).c_str(), static_cast<unsigned long long>(subtotal));
+            leaves += subtotal;
+        }
+    } else {
+        leaves = counter.count(pegs, depth);
+    }
+    double seconds = secondsSince(start);
+
+    std::printf("perft %s depth %d: %llu leaves\n", name.c_str(), depth, static_cast<unsigned long long>(leaves));
+    std::printf("%llu positions made in %.3f s (%.0f leaves/s, %.0f positions/s)\n",
+                static_cast<unsigned long long>(counter.nodes), seconds, seconds > 0.0 ? leaves / seconds : 0.0,
+                seconds > 0.0 ? counter.nodes / seconds : 0.0);
+    return 0;
+}
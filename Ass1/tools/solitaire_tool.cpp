@@ -0,0 +1,139 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "commands.h"
+#include "transposition_table.h"
+
+namespace {
+
+struct Command {
+    const char* name;
+    int (*run)(const std::vector<std::string>& args);
+    const char* help;
+};
+
+const Command COMMANDS[] = {
+    {"solve-min", runSolveMinMoves, "optimal solve counting chained jumps as one move"},
+    {"solve-goal", runSolveGoal, "meet-in-the-middle solve towards a chosen final position"},
+    {"generate", runGenerate, "generate graded, guaranteed-solvable puzzles"},
+    {"enumerate", runEnumerate, "disk-backed enumeration of every reachable position"},
+    {"shard", runShardWorker, "solve one shard of the opening prefixes"},
+    {"shard-merge", runShardMerge, "combine finished shard files"},
+    {"shard-run", runShardLocal, "run every shard as a local process, then merge"},
+    {"order-bench", runOrderBench, "compare move orderings over every single-vacancy start"},
+    {"count", runCount, "exact number of winning jump sequences, memoized and parallel"},
+    {"simulate", runSimulate, "batch self-play with random, greedy, epsilon-solver or MCTS policies"},
+    {"mcts", runMcts, "Monte Carlo tree search from a position, or a whole game played by it"},
+    {"records", runRecords, "replay and check a game record file, or show one record"},
+    {"serve", runServe, "hint daemon on a Unix socket, batching queries across a worker pool"},
+    {"hint-load", runHintLoad, "load generator for the hint daemon: throughput and tail latency"},
+    {"book-build", runBookBuild, "precompute an opening book of every position a few jumps from the start"},
+    {"book-probe", runBookProbe, "look a position up in an opening book, or time lookups"},
+};
+
+void printUsage() {
+    std::cout << "Usage: solitaire_tool <command> [options]\n\nCommands:\n";
+    for (const Command& command : COMMANDS) {
+        std::cout << "  " << command.name << "\t" << command.help << "\n";
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+bool parseShape(const std::string& name, BoardShape& shape) {
+    if (name == "english") {
+        shape = BoardShape::english();
+    } else if (name == "french") {
+        shape = BoardShape::french();
+    } else {
+        std::cerr << "Unknown board shape: " << name << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool parseHole(const BoardShape& shape, const std::string& text, int& hole) {
+    // Holes are given as "row,col"
+    int row, col;
+    char comma;
+    std::istringstream in(text);
+    if (!(in >> row >> comma >> col) || comma != ',' || !shape.isHole(row, col)) {
+        std::cerr << "Not a hole on the " << shape.getName() << " board: " << text << std::endl;
+        return false;
+    }
+    hole = shape.index(row, col);
+    return true;
+}
+
+bool parseTableMegabytes(const std::string& text, size_t& megabytes) {
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || value < TABLE_MIN_MEGABYTES || value > TABLE_MAX_MEGABYTES) {
+        std::cerr << "Table size must be " << TABLE_MIN_MEGABYTES << " to " << TABLE_MAX_MEGABYTES
+                  << " MB: " << text << std::endl;
+        return false;
+    }
+    megabytes = static_cast<size_t>(value);
+    return true;
+}
+
+bool parsePattern(const BoardShape& shape, const std::string& text, Bitboard& pegs) {
+    // One 'O' (marble) or '.' (empty) per hole in row-major order;
+    // anything else, such as '/' between rows, is ignored
+    pegs = 0;
+    Bitboard holes = shape.getHoles();
+    for (char c : text) {
+        if (c != 'O' && c != '.') continue;
+        if (!holes) {
+            std::cerr << "Pattern has more than " << shape.getHoleCount() << " holes" << std::endl;
+            return false;
+        }
+        int hole = lowestBit(holes);
+        holes &= holes - 1;
+        if (c == 'O') pegs |= Bitboard(1) << hole;
+    }
+    if (holes) {
+        std::cerr << "Pattern needs " << shape.getHoleCount() << " holes" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string formatPattern(const BoardShape& shape, Bitboard pegs) {
+    // The notation parsePattern() reads, with '/' between rows
+    std::string text;
+    for (int row = 0; row < shape.getSize(); row++) {
+        if (row > 0) text += '/';
+        for (int col = 0; col < shape.getSize(); col++) {
+            if (shape.isHole(row, col)) text += (pegs >> shape.index(row, col)) & 1 ? 'O' : '.';
+        }
+    }
+    return text;
+}
+
+std::string formatPosition(const Position& pos) {
+    return "(" + std::to_string(pos.row) + "," + std::to_string(pos.col) + ")";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<std::string> args(argv + 2, argv + argc);
+    for (const Command& command : COMMANDS) {
+        if (std::strcmp(argv[1], command.name) == 0) {
+            return command.run(args);
+        }
+    }
+
+    std::cerr << "Unknown command: " << argv[1] << std::endl;
+    printUsage();
+    return 1;
+}